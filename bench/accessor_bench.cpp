@@ -0,0 +1,332 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// std includes
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/optional.hpp>
+
+// local includes
+#include "../test/allocations.hpp"
+
+
+/*
+ * Benchmarks of the accessor kinds and of the accessor bundle's API
+ *
+ * Each benchmark is run for a minimum duration. The time and the number of
+ * dynamic allocations per operation are written to the standard output and,
+ * as JSON, to the file named by the first argument (`bench.json` by default).
+ */
+
+
+
+
+// Harness
+
+namespace {
+
+
+/**
+ * Prevent the compiler from optimizing away the computation of a value
+ */
+template <
+    typename Value
+>
+void
+keep(
+    Value const& value
+) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static void const* volatile sink;
+    sink = &value;
+#endif
+}
+
+
+struct result {
+    std::string name;
+    std::uint64_t iterations;
+    double nanoseconds; ///< per operation
+    double allocations; ///< per operation
+};
+
+
+/**
+ * Run a benchmark
+ *
+ * The `function` is called with the iteration's number as argument. The
+ * number of iterations is doubled until the benchmark runs for at least the
+ * minimum duration.
+ */
+template <
+    typename Function
+>
+result
+run(
+    std::string name,
+    Function&& function
+) {
+    typedef std::chrono::steady_clock clock;
+    auto const minimum = std::chrono::milliseconds(100);
+
+    // warm up
+    for (std::uint64_t i = 0; i < 1000; ++i)
+        function(i);
+
+    std::uint64_t iterations = 1000;
+    while (true) {
+        test::allocation_scope scope;
+        auto const start = clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i)
+            function(i);
+        auto const elapsed = clock::now() - start;
+        auto const allocated_during = scope.allocations();
+
+        if (elapsed >= minimum)
+            return result{
+                std::move(name),
+                iterations,
+                static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        elapsed
+                    ).count()
+                ) / iterations,
+                static_cast<double>(allocated_during) / iterations
+            };
+        iterations *= 2;
+    }
+}
+
+
+void
+write_json(
+    std::ostream& stream,
+    std::vector<result> const& results
+) {
+    stream << "{\n  \"benchmarks\": [";
+    char const* separator = "\n";
+    for (auto const& r : results) {
+        stream << separator
+            << "    {\"name\": \"" << r.name << "\""
+            << ", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << std::fixed << std::setprecision(3)
+            << r.nanoseconds
+            << ", \"allocs_per_op\": " << r.allocations << "}";
+        separator = ",\n";
+    }
+    stream << "\n  ]\n}\n";
+}
+
+
+}
+
+
+
+
+// Subject
+
+enum property {id, count, label, checksum};
+
+using id_attr = cmoh::attribute<property, id, int>;
+using count_attr = cmoh::attribute<property, count, int>;
+using label_attr = cmoh::attribute<property, label, std::string>;
+using checksum_attr = cmoh::attribute<property, checksum, const int>;
+
+
+struct record {
+    record(int id) : id(id) {}
+
+    int get_count() const { return count; }
+    void set_count(int const& value) { count = value; }
+
+    std::string get_label() const { return label; }
+    void set_label(std::string const& value) { label = value; }
+
+    int get_checksum() const { return id ^ count; }
+
+    // all members are public, so the type has a standard layout
+    int id;
+    int count = 0;
+    std::string label;
+};
+
+
+// packed header, as found e.g. in network packets
+enum header_property {fragment_offset, flags};
+
+using fragment_offset_attr =
+    cmoh::attribute<header_property, fragment_offset, std::uint16_t>;
+using flags_attr = cmoh::attribute<header_property, flags, std::uint16_t>;
+
+struct header {
+    std::uint8_t version;
+    std::uint8_t service;
+    std::uint16_t flags; // big endian, the offset in the lower 13 bits
+};
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto const accessors = cmoh::bundle(
+        cmoh::factory<record, id_attr>(),
+        id_attr::accessor<record>(offsetof(record, id)),
+        count_attr::accessor<record>(&record::get_count, &record::set_count),
+        label_attr::accessor<record>(&record::get_label, &record::set_label),
+        checksum_attr::accessor<record>(&record::get_checksum)
+    );
+
+    // the label is too long for any small string optimization
+    record subject(1);
+    subject.set_label("a label of considerable length");
+    std::vector<result> results;
+
+    // by_offset
+    results.push_back(run("get/static/by_offset", [&] (std::uint64_t) {
+        keep(accessors.get<id>(subject));
+    }));
+    results.push_back(run("set/static/by_offset", [&] (std::uint64_t i) {
+        accessors.set<id>(subject, static_cast<int>(i));
+        keep(subject);
+    }));
+
+    // by_invocable
+    results.push_back(run("get/static/by_invocable", [&] (std::uint64_t) {
+        keep(accessors.get<count>(subject));
+    }));
+    results.push_back(run("set/static/by_invocable", [&] (std::uint64_t i) {
+        accessors.set<count>(subject, static_cast<int>(i));
+        keep(subject);
+    }));
+    results.push_back(run("get/static/by_invocable/string", [&] (std::uint64_t) {
+        keep(accessors.get<label>(subject));
+    }));
+
+    // by_invocable_const
+    results.push_back(run("get/static/by_invocable_const", [&] (std::uint64_t) {
+        keep(accessors.get<checksum>(subject));
+    }));
+
+    // by_bits, accessing single objects and extracting from arrays of 1024
+    auto const offset_accessor = fragment_offset_attr::accessor<header>(
+        cmoh::bit_field<offsetof(header, flags), 0, 13, std::uint16_t, cmoh::byte_order::big>()
+    );
+    std::vector<header> headers(1024, header{0x45, 0, 0x1234});
+    std::vector<std::uint16_t> offsets(headers.size());
+    results.push_back(run("get/static/by_bits", [&] (std::uint64_t i) {
+        keep(offset_accessor.get(headers[i % headers.size()]));
+    }));
+    results.push_back(run("extract/by_bits/1024", [&] (std::uint64_t) {
+        offset_accessor.extract(
+            headers.data(),
+            headers.data() + headers.size(),
+            offsets.data()
+        );
+        keep(offsets);
+    }));
+
+    // by_wire_offset, loading and swapping a big endian value
+    auto const flags_accessor = flags_attr::accessor<header, std::uint16_t>(
+        cmoh::wire_offset<offsetof(header, flags), cmoh::byte_order::big>()
+    );
+    results.push_back(run("get/static/by_wire_offset", [&] (std::uint64_t i) {
+        keep(flags_accessor.get(headers[i % headers.size()]));
+    }));
+
+    // dynamic keys, cycling through the keys of the integral attributes
+    results.push_back(run("get/dynamic", [&] (std::uint64_t i) {
+        keep(accessors.get<int>(subject, static_cast<property>(i % 2)));
+    }));
+    results.push_back(run("set/dynamic", [&] (std::uint64_t i) {
+        keep(accessors.set<int>(
+            subject,
+            static_cast<property>(i % 2),
+            static_cast<int>(i)
+        ));
+    }));
+
+    // dynamic keys, unpacking the optional values returned
+    results.push_back(run("get/dynamic/value_or", [&] (std::uint64_t) {
+        int sum = 0;
+        for (auto key : {id, count, checksum})
+            sum += accessors.get<int>(subject, key).value_or(0);
+        keep(sum);
+    }));
+
+    // optional values collected from dynamic gets, copied as a whole
+    std::vector<cmoh::optional<int>> values(1024);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = accessors.get<int>(subject, static_cast<property>(i % 4));
+    std::vector<cmoh::optional<int>> copies(values.size());
+    results.push_back(run("copy/optional/1024", [&] (std::uint64_t) {
+        std::copy(values.cbegin(), values.cend(), copies.begin());
+        keep(copies);
+    }));
+
+    // constructor factory, with and without additional setters
+    results.push_back(run("create/constructor", [&] (std::uint64_t i) {
+        keep(accessors.create<id>(static_cast<int>(i)));
+    }));
+    results.push_back(run("create/constructor+setters", [&] (std::uint64_t i) {
+        keep(accessors.create<id, count>(static_cast<int>(i), 2));
+    }));
+
+    // visiting all properties
+    results.push_back(run("visit_properties", [&] (std::uint64_t) {
+        std::size_t visited = 0;
+        accessors.visit_properties([&visited] (auto const&) { ++visited; });
+        keep(visited);
+    }));
+
+
+    for (auto const& r : results)
+        std::cout << std::left << std::setw(32) << r.name
+            << std::right << std::fixed << std::setprecision(2)
+            << std::setw(10) << r.nanoseconds << " ns/op"
+            << std::setw(8) << r.allocations << " allocs/op" << std::endl;
+
+    std::ofstream json(argc > 1 ? argv[1] : "bench.json");
+    write_json(json, results);
+    if (!json) {
+        std::cerr << "Could not write results" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
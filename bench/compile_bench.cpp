@@ -0,0 +1,364 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// std includes
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// POSIX includes
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/*
+ * Compile time benchmarks of synthetic accessor bundles
+ *
+ * Translation units instantiating bundles of increasing size are generated in
+ * the directory `bench/compile/` and compiled using the compiler command
+ * supplied. For each unit, the wall clock time and the peak memory of the
+ * compiler are measured and compared to the budget configured, if any.
+ *
+ * Usage:
+ *
+ *     compile_bench [--all] <budget file> <result file> <compiler> [<flags>...]
+ *
+ * The budget file holds one line per budgeted unit, consisting of the unit's
+ * name, the maximum time in seconds and the maximum memory in MiB. Lines
+ * starting with `#` are ignored. The program fails if a budgeted unit does
+ * not compile or exceeds its budget.
+ *
+ * Additional flags, e.g. `-ftime-trace` or `-ftime-report`, are passed to the
+ * compiler. Traces are thus placed next to the generated units, along with the
+ * compiler's diagnostic output.
+ *
+ * By default, units using `cmoh::string_view` keys are not generated, since
+ * some compilers, e.g. GCC 12, reject reference-typed keys as template
+ * arguments (see `examples/string_key_example.cpp`). They are included if
+ * `--all` is passed.
+ */
+
+
+
+
+namespace {
+
+
+/**
+ * Kind of keys used by a generated bundle
+ */
+struct key_kind {
+    char const* name;
+    char const* key_type;
+    std::string (*declare)(std::size_t index);
+    bool by_default; ///< whether the kind is part of the default run
+};
+
+
+key_kind const key_kinds[] = {
+    {
+        "enum",
+        "key",
+        [] (std::size_t index) {
+            return "k" + std::to_string(index);
+        },
+        true
+    },
+    {
+        "int",
+        "int",
+        [] (std::size_t index) {
+            return std::to_string(index);
+        },
+        true
+    },
+    {
+        "string_view",
+        "cmoh::string_view const&",
+        [] (std::size_t index) {
+            return "k" + std::to_string(index);
+        },
+        false
+    }
+};
+
+
+std::size_t const sizes[] = {8, 16, 32, 64};
+
+// number of attributes per factory
+std::size_t const attributes_per_factory = 8;
+
+
+/**
+ * Generate a translation unit including the headers only
+ */
+std::string
+generate_headers() {
+    return
+        "#include <cmoh/accessor_bundle.hpp>\n"
+        "#include <cmoh/attribute.hpp>\n"
+        "#include <cmoh/factory.hpp>\n"
+        "#include <cmoh/string_view.hpp>\n";
+}
+
+
+/**
+ * Generate a translation unit instantiating a bundle
+ *
+ * The bundle holds `size` attributes, accessed via getters and setters, and
+ * one constructor factory for each `attributes_per_factory` attributes. The
+ * unit instantiates object creation, static get and set for each attribute,
+ * dynamic get and the visitation of all properties.
+ */
+std::string
+generate_bundle(
+    key_kind const& kind,
+    std::size_t size
+) {
+    std::ostringstream source;
+    source << generate_headers() << '\n';
+
+    // keys
+    if (kind.key_type == std::string("key")) {
+        source << "enum key {";
+        for (std::size_t i = 0; i < size; ++i)
+            source << (i ? ", " : "") << kind.declare(i);
+        source << "};\n";
+    } else if (kind.key_type != std::string("int")) {
+        for (std::size_t i = 0; i < size; ++i)
+            source << "extern constexpr cmoh::string_view const "
+                << kind.declare(i) << "{\"" << kind.declare(i) << "\"};\n";
+    }
+
+    // attributes
+    for (std::size_t i = 0; i < size; ++i)
+        source << "using a" << i << " = cmoh::attribute<" << kind.key_type
+            << ", " << kind.declare(i) << ", int>;\n";
+
+    // object
+    source << "\nstruct object {\n    object(int value) : v0(value) {}\n";
+    for (std::size_t i = 0; i < size; ++i)
+        source << "    int get" << i << "() const { return v" << i << "; }\n"
+            << "    void set" << i << "(int const& value) { v" << i
+            << " = value; }\n";
+    for (std::size_t i = 0; i < size; ++i)
+        source << "    int v" << i << " = 0;\n";
+    source << "};\n\n";
+
+    // bundle
+    source << "int run(int value) {\n    auto const b = cmoh::bundle(\n";
+    for (std::size_t i = 0; i < size; i += attributes_per_factory)
+        source << "        cmoh::factory<object, a" << i << ">(),\n";
+    for (std::size_t i = 0; i < size; ++i)
+        source << "        a" << i << "::accessor<object>(&object::get" << i
+            << ", &object::set" << i << ")" << (i + 1 < size ? "," : "")
+            << "\n";
+    source << "    );\n\n";
+
+    // uses
+    source << "    auto o = b.create<" << kind.declare(0) << ">(value + 0);\n";
+    for (std::size_t i = 1; i < size; ++i)
+        source << "    b.set<" << kind.declare(i) << ">(o, b.get<"
+            << kind.declare(i - 1) << ">(o) + 1);\n";
+    source << "    int sum = b.get<int>(o, " << kind.declare(size - 1)
+        << ").value_or(0);\n"
+        << "    b.visit_properties([&] (auto const&) { ++sum; });\n"
+        << "    return sum;\n}\n";
+
+    return source.str();
+}
+
+
+struct measurement {
+    std::string name;
+    bool compiled;
+    double seconds;
+    double mebibytes;
+};
+
+
+/**
+ * Compile a translation unit, measuring the time and peak memory
+ */
+measurement
+compile(
+    std::string const& name,
+    std::string const& source,
+    std::vector<std::string> const& compiler
+) {
+    auto const path = "bench/compile/" + name;
+    std::ofstream(path + ".cpp") << source;
+
+    std::string command;
+    for (auto const& arg : compiler)
+        command += arg + ' ';
+    command += "-c -o " + path + ".o " + path + ".cpp 2> " + path + ".log";
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const pid = fork();
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage{};
+    bool const waited = (pid > 0) && (wait4(pid, &status, 0, &usage) == pid);
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    // `ru_maxrss` is given in kibibytes on Linux but in bytes on macOS
+#ifdef __APPLE__
+    double const mebibytes = usage.ru_maxrss / (1024. * 1024.);
+#else
+    double const mebibytes = usage.ru_maxrss / 1024.;
+#endif
+
+    return measurement{
+        name,
+        waited && WIFEXITED(status) && (WEXITSTATUS(status) == 0),
+        std::chrono::duration<double>(elapsed).count(),
+        mebibytes
+    };
+}
+
+
+struct budget {
+    double seconds;
+    double mebibytes;
+};
+
+
+std::map<std::string, budget>
+read_budgets(
+    std::istream& stream
+) {
+    std::map<std::string, budget> retval;
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::string name;
+        budget b;
+        if (fields >> name >> b.seconds >> b.mebibytes)
+            retval[name] = b;
+    }
+    return retval;
+}
+
+
+}
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto const program = argv[0];
+    auto const all = (argc > 1) && (argv[1] == std::string("--all"));
+    if (all) {
+        --argc;
+        ++argv;
+    }
+
+    if (argc < 4) {
+        std::cerr << "Usage: " << program
+            << " [--all] <budget file> <result file> <compiler> [<flags>...]"
+            << std::endl;
+        return 2;
+    }
+
+    std::ifstream budget_file(argv[1]);
+    if (!budget_file) {
+        std::cerr << "Could not read budgets from " << argv[1] << std::endl;
+        return 2;
+    }
+    auto const budgets = read_budgets(budget_file);
+    std::vector<std::string> const compiler(argv + 3, argv + argc);
+
+    mkdir("bench/compile", 0777);
+
+    std::vector<measurement> results;
+    results.push_back(compile("headers", generate_headers(), compiler));
+    for (auto const& kind : key_kinds) {
+        if (!all && !kind.by_default)
+            continue;
+        for (auto size : sizes)
+            results.push_back(compile(
+                std::string(kind.name) + '_' + std::to_string(size),
+                generate_bundle(kind, size),
+                compiler
+            ));
+    }
+
+    bool success = true;
+    std::ofstream json(argv[2]);
+    json << "{\n  \"units\": [";
+    char const* separator = "\n";
+    for (auto const& m : results) {
+        auto const b = budgets.find(m.name);
+        auto const budgeted = b != budgets.end();
+        char const* verdict = "ok";
+        if (!m.compiled)
+            verdict = "failed";
+        else if (budgeted && m.seconds > b->second.seconds)
+            verdict = "over time budget";
+        else if (budgeted && m.mebibytes > b->second.mebibytes)
+            verdict = "over memory budget";
+        if (budgeted && verdict != std::string("ok"))
+            success = false;
+
+        std::cout << std::left << std::setw(20) << m.name
+            << std::right << std::fixed << std::setprecision(2)
+            << std::setw(8) << m.seconds << " s"
+            << std::setw(10) << m.mebibytes << " MiB  " << verdict
+            << (budgeted ? "" : " (no budget)") << std::endl;
+
+        json << separator
+            << "    {\"name\": \"" << m.name << "\""
+            << ", \"compiled\": " << (m.compiled ? "true" : "false")
+            << ", \"seconds\": " << std::fixed << std::setprecision(3)
+            << m.seconds
+            << ", \"mebibytes\": " << m.mebibytes << "}";
+        separator = ",\n";
+    }
+    json << "\n  ]\n}\n";
+
+    if (!json) {
+        std::cerr << "Could not write results to " << argv[2] << std::endl;
+        return 1;
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/arena.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+enum attribute {birthday, first_name, last_name, name};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+
+
+// A string using an arena for its characters
+using arena_string = std::basic_string<
+    char,
+    std::char_traits<char>,
+    cmoh::arena_allocator<char>
+>;
+
+// A simple type with an allocator-aware attribute
+struct label {
+    arena_string text;
+};
+
+using name_attr = cmoh::attribute<attribute, name, const arena_string>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name)
+    );
+
+    auto const now = std::chrono::system_clock::now();
+
+    {
+        // We create a bunch of objects in an arena. The arena starts out with
+        // a buffer we supply and allocates further blocks if necessary.
+        alignas(std::max_align_t) unsigned char buffer[1024];
+        cmoh::arena arena(buffer, sizeof(buffer));
+
+        std::vector<person*> people;
+        for (int i = 0; i < 100; ++i)
+            people.push_back(accessors.create_in<birthday, first_name, last_name>(
+                arena,
+                now - std::chrono::hours(24*i),
+                "Hans",
+                "Wurst"
+            ));
+
+        assert(accessors.get<first_name>(*people.front()) == "Hans");
+        assert(people.back()->age() >= std::chrono::hours(24*99));
+        std::cout << "Created " << people.size() << " people in an arena" << std::endl;
+
+        // All the objects are destroyed and the memory is freed at once
+        arena.release();
+    }
+
+    {
+        // Values of allocator-aware attributes are rebuilt using the arena's
+        // allocator, so they don't use the global allocator either.
+        auto labels = bundle(
+            cmoh::factory<label, name_attr>(),
+            name_attr::accessor<label>([] (label const& l) { return l.text; })
+        );
+
+        cmoh::arena arena;
+        cmoh::arena other;
+        auto l = labels.create_in<name>(
+            arena,
+            arena_string("a label which is too long for small strings", other.get_allocator())
+        );
+
+        assert(l->text == "a label which is too long for small strings");
+        assert(l->text.get_allocator() == arena.get_allocator());
+        std::cout << "Label: " << l->text << std::endl;
+    }
+
+    {
+        // If the buffer is exhausted, the padding for aligning memory does not
+        // fit either. The memory is taken from a new block instead.
+        alignas(16) unsigned char buffer[33];
+        cmoh::arena arena(buffer, sizeof(buffer));
+        arena.allocate(sizeof(buffer), 1);
+        auto memory = static_cast<unsigned char*>(arena.allocate(8, 16));
+        assert((memory < buffer) || (memory >= buffer + sizeof(buffer)));
+    }
+
+    return 0;
+}
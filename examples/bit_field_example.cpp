@@ -0,0 +1,157 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+
+
+
+
+// Legacy C structs, e.g. headers of network packets, often pack several values
+// into a few bytes. This one resembles the beginning of an IPv4 header, in
+// which multi-byte values are stored in big endian byte order.
+struct header {
+    std::uint8_t version_length; // version and header length, 4 bits each
+    std::uint8_t service; // the two lowest bits hold a congestion code
+    std::uint16_t total_length;
+    std::uint16_t identification;
+    std::uint16_t flags_offset; // 3 bits of flags and 13 bits of offset
+};
+
+
+enum class congestion : std::uint8_t {none, capable0, capable1, experienced};
+
+
+enum attribute {version, length, congestion_code, dont_fragment, fragment_offset};
+
+using version_attr = cmoh::attribute<attribute, version, unsigned int>;
+using length_attr = cmoh::attribute<attribute, length, unsigned int>;
+using congestion_attr = cmoh::attribute<attribute, congestion_code, congestion>;
+using dont_fragment_attr = cmoh::attribute<attribute, dont_fragment, bool>;
+using fragment_offset_attr =
+    cmoh::attribute<attribute, fragment_offset, std::uint16_t>;
+
+
+// The location of each field is specified via a `cmoh::bit_field`, consisting
+// of the byte offset of the value holding the field, the first bit and the
+// number of bits. Optionally, the type and byte order of the value holding the
+// field may be specified.
+using flags_offset = cmoh::bit_field<
+    offsetof(header, flags_offset),
+    0,
+    13,
+    std::uint16_t,
+    cmoh::byte_order::big
+>;
+using dont_fragment_bit = cmoh::bit_field<
+    offsetof(header, flags_offset),
+    14,
+    1,
+    std::uint16_t,
+    cmoh::byte_order::big
+>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        version_attr::accessor<header>(
+            cmoh::bit_field<offsetof(header, version_length), 4, 4>()
+        ),
+        length_attr::accessor<header>(
+            cmoh::bit_field<offsetof(header, version_length), 0, 4>()
+        ),
+        congestion_attr::accessor<header>(
+            cmoh::bit_field<offsetof(header, service), 0, 2>()
+        ),
+        dont_fragment_attr::accessor<header>(dont_fragment_bit()),
+        fragment_offset_attr::accessor<header>(flags_offset())
+    );
+
+    // We overlay a header on some bytes, as received from the wire
+    unsigned char const bytes[] = {0x45, 0x03, 0x00, 0x54, 0x12, 0x34, 0x40, 0x05};
+    header h;
+    static_assert(sizeof(h) == sizeof(bytes), "Unexpected padding");
+    std::memcpy(&h, bytes, sizeof(h));
+
+    std::cout << "Version: " << accessors.get<version>(h) << std::endl;
+    assert(accessors.get<version>(h) == 4);
+    assert(accessors.get<length>(h) == 5);
+    assert(accessors.get<congestion_code>(h) == congestion::experienced);
+    assert(accessors.get<dont_fragment>(h));
+    std::cout << "Fragment offset: " << accessors.get<fragment_offset>(h)
+        << std::endl;
+    assert(accessors.get<fragment_offset>(h) == 5);
+
+    // Setting a field preserves the surrounding bits
+    accessors.set<fragment_offset>(h, 0x1abc);
+    accessors.set<congestion_code>(h, congestion::none);
+    assert(accessors.get<fragment_offset>(h) == 0x1abc);
+    assert(accessors.get<dont_fragment>(h));
+    assert(accessors.get<version>(h) == 4);
+    {
+        auto raw = reinterpret_cast<unsigned char const*>(&h);
+        assert(raw[1] == 0x00);
+        assert((raw[6] == 0x5a) && (raw[7] == 0xbc));
+    }
+
+    // Dynamic access works like with any other accessor
+    assert(accessors.set<unsigned int>(h, length, 6));
+    assert(accessors.get<unsigned int>(h, length).value_or(0) == 6);
+
+    {
+        // A field may be extracted from an array of objects at once. The
+        // accessor's `extract()` is written such that compilers are able to
+        // vectorize it.
+        std::vector<header> headers(64, h);
+        for (std::size_t i = 0; i < headers.size(); ++i)
+            accessors.set<fragment_offset>(headers[i], static_cast<std::uint16_t>(i));
+
+        std::vector<std::uint16_t> offsets(headers.size());
+        fragment_offset_attr::accessor<header>(flags_offset()).extract(
+            headers.data(),
+            headers.data() + headers.size(),
+            offsets.data()
+        );
+        for (std::size_t i = 0; i < offsets.size(); ++i)
+            assert(offsets[i] == i);
+        assert(accessors.get<dont_fragment>(headers.back()));
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <iostream>
+#include <unordered_set>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/hash.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+// Like in the attribute example, we declare a few attributes
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    auto const now = std::chrono::system_clock::now();
+    person hans = accessors.create<birthday, first_name, last_name>(
+        now - std::chrono::hours(24), "Hans", "Wurst"
+    );
+    person lisa = accessors.create<birthday, first_name, last_name>(
+        now - std::chrono::hours(24), "Lisa", "Wurst"
+    );
+
+    // Objects are compared by the values of their attributes. We don't need to
+    // write any comparison operator ourselves.
+    person other_hans = hans;
+    assert(accessors.equal(hans, other_hans));
+    assert(!accessors.equal(hans, lisa));
+
+    // We also get an ordering...
+    assert(accessors.compare(hans, lisa) < 0);
+    assert(accessors.compare(lisa, hans) > 0);
+    assert(accessors.compare(hans, other_hans) == 0);
+
+    // ... and a hash, which we can use for unordered containers.
+    assert(accessors.hash(hans) == accessors.hash(other_hans));
+    auto hash = [&] (person const& p) { return accessors.hash(p); };
+    auto equal = [&] (person const& lhs, person const& rhs) {
+        return accessors.equal(lhs, rhs);
+    };
+    std::unordered_set<person, decltype(hash), decltype(equal)> people(
+        8, hash, equal
+    );
+    people.insert(hans);
+    people.insert(lisa);
+    people.insert(other_hans);
+    std::cout << "Distinct persons: " << people.size() << std::endl;
+    assert(people.size() == 2);
+
+    return 0;
+}
+
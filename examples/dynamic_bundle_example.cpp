@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/dynamic_bundle.hpp>
+#include <cmoh/factory.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+// A host which knows nothing about `person` and operates on any object via a
+// dynamic bundle.
+static
+std::vector<cmoh::encoding::byte>
+serialize_all(
+    cmoh::dynamic_bundle<attribute> const& accessors,
+    void const* obj
+) {
+    std::vector<cmoh::encoding::byte> retval;
+    for (std::size_t id = 0; id < accessors.size(); ++id)
+        if (accessors[id].set)
+            accessors.serialize(obj, id, retval);
+    return retval;
+}
+
+static
+bool
+deserialize_all(
+    cmoh::dynamic_bundle<attribute> const& accessors,
+    void* obj,
+    std::vector<cmoh::encoding::byte> const& buffer
+) {
+    auto pos = buffer.data();
+    for (std::size_t id = 0; id < accessors.size(); ++id)
+        if (accessors[id].set &&
+            !accessors.deserialize(obj, id, pos, buffer.data() + buffer.size()))
+            return false;
+    return pos == buffer.data() + buffer.size();
+}
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    // We erase the type of the bundle. The dynamic bundle contains one entry
+    // per attribute.
+    auto dynamic = cmoh::make_dynamic(accessors);
+    assert(dynamic.size() == 3);
+    assert(dynamic.object_type() == cmoh::tag_of<person>());
+
+    for (auto const& entry : dynamic)
+        std::cout << "Attribute " << entry.key << (entry.set ? "" : " (const)") << std::endl;
+
+    person p = accessors.create<birthday, first_name, last_name>(
+        std::chrono::system_clock::now() - std::chrono::hours(48),
+        "Hans",
+        "Wurst"
+    );
+
+    // Attributes are accessed via ids, which may be looked up by key. Values
+    // are passed with their type checked at run time.
+    auto const id = dynamic.id_of(first_name);
+    assert(id < dynamic.size());
+    assert(*dynamic.get<std::string>(&p, id) == "Hans");
+    assert(!dynamic.get<int>(&p, id));
+    assert(dynamic.set<std::string>(&p, id, "Henrick"));
+    assert(p.first_name() == "Henrick");
+    assert(!dynamic.set<std::chrono::hours>(&p, dynamic.id_of(age), std::chrono::hours(1)));
+    assert(dynamic.get<std::chrono::hours>(&p, dynamic.id_of(age))->count() >= 48);
+
+    // Unknown keys yield an id of `size()`, which all operations reject
+    auto const unknown = dynamic.id_of(birthday);
+    assert(unknown == dynamic.size());
+    assert(!dynamic.get<std::string>(&p, unknown));
+    assert(!dynamic.set<std::string>(&p, unknown, "Hans"));
+    std::vector<cmoh::encoding::byte> scratch;
+    assert(!dynamic.serialize(&p, unknown, scratch) && scratch.empty());
+
+    // Attributes may also be serialized and deserialized
+    auto const buffer = serialize_all(dynamic, &p);
+    person q(std::chrono::system_clock::now());
+    assert(deserialize_all(dynamic, &q, buffer));
+    assert(q.first_name() == "Henrick" && q.last_name() == "Wurst");
+    std::cout << "Transferred " << buffer.size() << " bytes" << std::endl;
+
+    return 0;
+}
@@ -73,6 +73,24 @@ int main(int argc, char* argv[]) {
         assert(!name.has_value());
     }
 
+    {
+        // Attributes are also reachable via a dense index, which may be
+        // looked up once and reused
+        static_assert(decltype(accessors)::index_of<1>() == 0, "Wrong index");
+        auto index = accessors.index_of(1);
+        assert(index == 0);
+        assert(accessors.key_at(index) == 1);
+        assert(accessors.index_of(2) == decltype(accessors)::npos);
+
+        std::string name;
+        assert(accessors.get_at(p, index, [&name] (std::string const& value) {
+            name = value;
+        }));
+        std::cout << "Name at index " << index << ": " << name << std::endl;
+        assert(name == "Lisa");
+        assert(!accessors.get_at(p, 1, [] (std::string const&) {}));
+    }
+
     return 0;
 }
 
@@ -0,0 +1,190 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+enum attribute {birthday, first_name, last_name};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+
+
+// A trivial type which refuses negative coordinates
+struct point {
+    point() = default;
+    point(int x) : _x(x) {}
+
+    int x() const { return _x; }
+    int y() const { return _y; }
+
+    void set_y(int value) {
+        if (value < 0)
+            throw std::invalid_argument("negative coordinate");
+        _y = value;
+    }
+
+private:
+    int _x;
+    int _y;
+};
+
+enum coordinate {x, y};
+
+using x_attr = cmoh::attribute<coordinate, x, const int>;
+using y_attr = cmoh::attribute<coordinate, y, int>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name)
+    );
+
+    auto const now = std::chrono::system_clock::now();
+
+    {
+        // We can create an object directly in storage we provide, e.g. an
+        // entry of a ring buffer. We are responsible for destroying it.
+        std::aligned_storage<sizeof(person), alignof(person)>::type storage;
+        person* p = accessors.create_at<birthday, first_name, last_name>(
+            &storage,
+            now - std::chrono::hours(48),
+            "Hans",
+            "Wurst"
+        );
+
+        assert(static_cast<void*>(p) == static_cast<void*>(&storage));
+        assert(accessors.get<first_name>(*p) == "Hans");
+        std::cout << "Created " << p->first_name() << " in place" << std::endl;
+        p->~person();
+    }
+
+    {
+        // We can also append objects to containers without moving them
+        std::vector<person> people;
+        people.reserve(10);
+        for (int i = 0; i < 10; ++i)
+            accessors.emplace_into<birthday, first_name>(
+                people,
+                now - std::chrono::hours(24*i),
+                "Hans"
+            );
+
+        std::deque<person> more;
+        auto& p = accessors.emplace_into<birthday, last_name>(
+            more,
+            now - std::chrono::hours(24),
+            "Wurst"
+        );
+
+        assert(people.size() == 10);
+        assert(accessors.get<first_name>(people.back()) == "Hans");
+        assert(&p == &more.back());
+        assert(accessors.get<last_name>(p) == "Wurst");
+        std::cout << "Appended " << people.size() + more.size() << " people" << std::endl;
+    }
+
+    {
+        // Whole batches of objects may be created from columns of values, e.g.
+        // as produced by a decoder. The values are moved out of the columns.
+        std::vector<std::chrono::system_clock::time_point> birthdays;
+        std::vector<std::string> first_names;
+        for (int i = 0; i < 100; ++i) {
+            birthdays.push_back(now - std::chrono::hours(24*i));
+            first_names.push_back("Person #" + std::to_string(i));
+        }
+
+        std::vector<person> people;
+        accessors.create_batch<birthday, first_name>(
+            people,
+            birthdays.size(),
+            birthdays.begin(),
+            first_names.begin()
+        );
+
+        assert(people.size() == 100);
+        assert(accessors.get<first_name>(people[42]) == "Person #42");
+        assert(people[42].age() >= std::chrono::hours(24*42));
+        std::cout << "Created a batch of " << people.size() << " people" << std::endl;
+    }
+
+    {
+        // Batches of trivial objects are created in place after resizing the
+        // container once. If an object can not be created, the objects
+        // appended are removed again.
+        auto point_accessors = bundle(
+            cmoh::factory<point, x_attr>(),
+            x_attr::accessor<point>(&point::x),
+            y_attr::accessor<point>(&point::y, &point::set_y)
+        );
+
+        std::vector<point> points(1);
+        std::vector<int> xs{1, 2, 3};
+        std::vector<int> ys{4, 5, 6};
+        point_accessors.create_batch<x, y>(points, 3, xs.begin(), ys.begin());
+        assert(points.size() == 4);
+        assert(point_accessors.get<x>(points[3]) == 3);
+        assert(point_accessors.get<y>(points[3]) == 6);
+
+        ys[1] = -1;
+        bool failed = false;
+        try {
+            point_accessors.create_batch<x, y>(points, 3, xs.begin(), ys.begin());
+        } catch (std::invalid_argument const&) {
+            failed = true;
+        }
+        assert(failed && (points.size() == 4));
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <iostream>
+#include <type_traits>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+
+
+
+
+enum attribute {x, y, z};
+
+using x_attr = cmoh::attribute<attribute, x, int>;
+using y_attr = cmoh::attribute<attribute, y, int>;
+using z_attr = cmoh::attribute<attribute, z, int>;
+
+
+// A simple type which may be constructed in several ways
+class point {
+public:
+    point(int x) : _x(x) {}
+    point(int x, int y) : _x(x), _y(y) {}
+
+    int x() const { return _x; }
+    void set_x(int value) { _x = value; }
+
+    int y() const { return _y; }
+    void set_y(int value) { _y = value; }
+
+    int z() const { return _z; }
+    void set_z(int value) { _z = value; }
+
+private:
+    int _x = 0;
+    int _y = 0;
+    int _z = 0;
+};
+
+
+
+
+int main(int argc, char* argv[]) {
+    // With several factories present, the bundle selects the one requiring the
+    // fewest attributes to be set after construction, regardless of the order.
+    auto accessors = bundle(
+        cmoh::factory<point, x_attr>(),
+        cmoh::factory<point, x_attr, y_attr>(),
+        x_attr::accessor<point>(&point::x, &point::set_x),
+        y_attr::accessor<point>(&point::y, &point::set_y),
+        z_attr::accessor<point>(&point::z, &point::set_z)
+    );
+
+    static_assert(
+        std::is_same<
+            decltype(accessors)::factory_for<x, y, z>,
+            cmoh::accessors::factory::constructor<point, x_attr, y_attr>
+        >::value,
+        "Unexpected factory selected"
+    );
+    static_assert(accessors.setter_count<x, y, z>() == 1, "Unexpected setter count");
+    static_assert(accessors.setter_count<x, z>() == 1, "Unexpected setter count");
+    static_assert(accessors.setter_count<x>() == 0, "Unexpected setter count");
+
+    auto p = accessors.create<x, y, z>(1, 2, 3);
+    assert((p.x() == 1) && (p.y() == 2) && (p.z() == 3));
+
+    // We can find out which attributes are set after construction
+    std::cout << "Attributes set after construction:";
+    accessors.visit_setters<x, y, z>([] (auto const& accessor) {
+        std::cout << " " << cmoh::accessors::key(accessor);
+    });
+    std::cout << std::endl;
+
+    // Factories may be declared to be more expensive, e.g. if a constructor
+    // performs some costly operation.
+    auto weighted = bundle(
+        cmoh::with_cost<2>(cmoh::factory<point, x_attr, y_attr>()),
+        cmoh::factory<point, x_attr>(),
+        x_attr::accessor<point>(&point::x, &point::set_x),
+        y_attr::accessor<point>(&point::y, &point::set_y),
+        z_attr::accessor<point>(&point::z, &point::set_z)
+    );
+
+    static_assert(
+        std::is_same<
+            decltype(weighted)::factory_for<x, y>,
+            cmoh::accessors::factory::constructor<point, x_attr>
+        >::value,
+        "Unexpected factory selected"
+    );
+    static_assert(weighted.setter_count<x, y, z>() == 2, "Unexpected setter count");
+
+    auto q = weighted.create<x, y>(4, 5);
+    assert((q.x() == 4) && (q.y() == 5));
+
+    return 0;
+}
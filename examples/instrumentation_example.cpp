@@ -0,0 +1,121 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/instrumented.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+// Like in the attribute example, we declare a few attributes
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    person p = accessors.create<birthday, first_name, last_name>(
+        std::chrono::system_clock::now() - std::chrono::hours(24),
+        "Hans",
+        "Wurst"
+    );
+
+    // An instrumented bundle counts accesses to each of the attributes. The
+    // factory is not an attribute accessor, so the `first_name` attribute
+    // has the index 0.
+    auto probe = cmoh::instrument<cmoh::instrumentation::timing>(accessors);
+    assert(probe.get<first_name>(p) == "Hans");
+    probe.set<last_name>(p, "Meier");
+    assert(*probe.get<std::string>(p, last_name) == "Meier");
+    assert(!probe.get<std::string>(p, birthday));
+    assert(!probe.set<std::string>(p, age, "old"));
+
+    // Each thread counts in a block of its own. The blocks are aggregated
+    // only when a snapshot is taken.
+    std::thread worker([&probe, &p] () {
+        for (int i = 0; i < 1000; ++i)
+            probe.get<age>(p);
+    });
+    worker.join();
+
+    auto stats = probe.snapshot();
+    assert(stats.attributes[0].gets == 1);
+    assert(stats.attributes[1].gets == 1);
+    assert(stats.attributes[1].sets == 1);
+    assert(stats.attributes[2].gets == 1000);
+    assert(stats.misses == 2);
+
+    std::ostringstream dump;
+    probe.dump(dump);
+    std::cout << dump.str();
+    assert(dump.str().find("attribute=2 gets=1000 sets=0 ns=") != std::string::npos);
+    assert(dump.str().find("misses=2\n") != std::string::npos);
+
+    // With instrumentation disabled, the instrumented bundle merely forwards
+    // calls to the bundle and holds no counters at all. This is the policy
+    // used by default, unless `CMOH_INSTRUMENTATION` is defined.
+    auto plain = cmoh::instrument<cmoh::instrumentation::disabled>(accessors);
+    static_assert(
+        sizeof(plain) == sizeof(void*),
+        "Disabled instrumentation holds more than a reference to the bundle"
+    );
+    assert(plain.get<first_name>(p) == "Hans");
+    assert(plain.snapshot().attributes.size() == 3);
+    assert(plain.snapshot().attributes[2].gets == 0);
+
+    std::ostringstream plain_dump;
+    plain.dump(plain_dump);
+    assert(plain_dump.str().find("attribute=2 gets=0 sets=0 ns=0\n") != std::string::npos);
+
+    return 0;
+}
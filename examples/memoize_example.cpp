@@ -0,0 +1,145 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/accessors/attribute/memoized.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/dynamic_bundle.hpp>
+#include <cmoh/factory.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+enum attribute {birthday, first_name, last_name, full_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using full_name_attr = cmoh::attribute<attribute, full_name, const std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+// Memoized values are stored in slots embedded in the objects. Hence, we extend
+// our `person` by a slot for each of the values we want to memoize.
+struct memo_person : person {
+    using person::person;
+
+    cmoh::memo<std::string> full_name_memo;
+    cmoh::memo<std::chrono::hours> age_memo;
+};
+
+
+// We count how often the full name is actually computed
+static int computations = 0;
+
+static
+std::string
+get_full_name(memo_person const& p) {
+    ++computations;
+    std::ostringstream buf;
+    buf << p.first_name() << " " << p.last_name();
+    return buf.str();
+}
+
+
+
+
+int main(int argc, char* argv[]) {
+    // A memoizing accessor wraps a regular, read-only accessor. We declare the
+    // attributes the value depends on. Setting one of them via the bundle will
+    // invalidate the memoized value. The age only changes over time, hence we
+    // let the memoized value expire after a minute.
+    auto accessors = bundle(
+        cmoh::factory<memo_person, birthday_attr>(),
+        first_name_attr::accessor<memo_person>(
+            &person::first_name,
+            &person::set_first_name
+        ),
+        last_name_attr::accessor<memo_person>(
+            &person::last_name,
+            &person::set_last_name
+        ),
+        cmoh::memoize<first_name_attr, last_name_attr>(
+            full_name_attr::accessor<memo_person>(&get_full_name),
+            &memo_person::full_name_memo
+        ),
+        cmoh::memoize<>(
+            age_attr::accessor<memo_person>(&person::age),
+            &memo_person::age_memo,
+            std::chrono::minutes(1)
+        )
+    );
+
+    memo_person p = accessors.create<birthday, first_name, last_name>(
+        std::chrono::system_clock::now() - std::chrono::hours(48),
+        "Hans",
+        "Wurst"
+    );
+
+    // The full name is only computed once, regardless of how often we query it
+    assert(accessors.get<full_name>(p) == "Hans Wurst");
+    assert(accessors.get<full_name>(p) == "Hans Wurst");
+    assert(computations == 1);
+    std::cout << "Name: " << accessors.get<full_name>(p) << std::endl;
+
+    // Setting a dependency via the bundle invalidates the memoized value...
+    accessors.set<first_name>(p, "Henrick");
+    assert(accessors.get<full_name>(p) == "Henrick Wurst");
+    assert(computations == 2);
+    std::cout << "Name: " << accessors.get<full_name>(p) << std::endl;
+
+    // ... regardless of whether the key is given at compile time or at run
+    // time.
+    accessors.set<std::string>(p, last_name, "Meier");
+    assert(accessors.get<full_name>(p) == "Henrick Meier");
+    assert(computations == 3);
+
+    // A dynamic bundle created from the bundle also invalidates the memoized
+    // value when setting a dependency.
+    auto dynamic = cmoh::make_dynamic(accessors);
+    assert(dynamic.set<std::string>(&p, dynamic.id_of(first_name), "Hans"));
+    assert(accessors.get<full_name>(p) == "Hans Meier");
+    assert(computations == 4);
+
+    // Values depending on the passing of time may expire
+    assert(accessors.get<age>(p).count() >= 48);
+    std::cout << "Age: " << accessors.get<age>(p).count() << " hours" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/accessors/attribute/nested.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/path.hpp>
+
+
+
+
+// Our objects nest: a customer has an address, which has a city. Each of the
+// types has its own set of attributes.
+struct city {
+    std::string name;
+    unsigned int zip;
+};
+
+enum city_key {city_name, city_zip};
+
+using city_name_attr = cmoh::attribute<city_key, city_name, std::string>;
+using city_zip_attr = cmoh::attribute<city_key, city_zip, unsigned int>;
+
+
+// We count the copies of addresses in order to show that evaluating paths does
+// not copy intermediate objects.
+static int address_copies = 0;
+
+class address {
+public:
+    address(std::string street, city c) : _street(street), _city(c) {}
+    address(address const& other) :
+            _street(other._street), _city(other._city) {
+        ++address_copies;
+    }
+
+    std::string street() const {
+        return _street;
+    }
+
+    city const& get_city() const {
+        return _city;
+    }
+
+private:
+    std::string _street;
+    city _city;
+};
+
+enum address_key {address_street, address_city};
+
+using street_attr = cmoh::attribute<address_key, address_street, const std::string>;
+using city_attr = cmoh::attribute<address_key, address_city, const city>;
+
+
+class customer {
+public:
+    customer(std::string name, address a) : _name(name), _address(a) {}
+
+    std::string name() const {
+        return _name;
+    }
+
+    address const& get_address() const {
+        return _address;
+    }
+
+private:
+    std::string _name;
+    address _address;
+};
+
+enum customer_key {customer_name, customer_address};
+
+using name_attr = cmoh::attribute<customer_key, customer_name, const std::string>;
+using address_attr = cmoh::attribute<customer_key, customer_address, const address>;
+
+
+// Paths are strings. Hence, we need to convert the segments to the keys used
+// by the various bundles. The parser has to handle all of the key types.
+struct key_parser {
+    template <
+        typename KeyType
+    >
+    static
+    bool
+    lookup(
+        cmoh::string_view segment,
+        KeyType& key,
+        std::initializer_list<char const*> names
+    ) {
+        int value = 0;
+        for (auto name : names) {
+            if (segment == cmoh::string_view(name)) {
+                key = static_cast<KeyType>(value);
+                return true;
+            }
+            ++value;
+        }
+        return false;
+    }
+
+    bool operator() (cmoh::string_view segment, city_key& key) const {
+        return lookup(segment, key, {"name", "zip"});
+    }
+
+    bool operator() (cmoh::string_view segment, address_key& key) const {
+        return lookup(segment, key, {"street", "city"});
+    }
+
+    bool operator() (cmoh::string_view segment, customer_key& key) const {
+        return lookup(segment, key, {"name", "address"});
+    }
+};
+
+
+// Visitor retrieving the address of a zip code
+struct zip_visitor {
+    unsigned int const* zip = nullptr;
+
+    void operator() (unsigned int const& value) {
+        zip = &value;
+    }
+
+    template <
+        typename Value
+    >
+    void operator() (Value const&) {}
+};
+
+
+
+
+int main(int argc, char* argv[]) {
+    // We specify how to access the attributes of each type. Attributes holding
+    // nested objects are declared using `cmoh::nest()`, which takes the
+    // accessor for the attribute and the bundle for the nested object's type.
+    auto city_accessors = bundle(
+        city_name_attr::accessor<city>(offsetof(city, name)),
+        city_zip_attr::accessor<city>(offsetof(city, zip))
+    );
+
+    auto address_accessors = bundle(
+        street_attr::accessor<address>(&address::street),
+        cmoh::nest(city_attr::accessor<address>(&address::get_city), city_accessors)
+    );
+
+    auto accessors = bundle(
+        name_attr::accessor<customer>(&customer::name),
+        cmoh::nest(
+            address_attr::accessor<customer>(&customer::get_address),
+            address_accessors
+        )
+    );
+
+    customer c("Jane", address("Main Street 1", city{"Springfield", 12345}));
+    address_copies = 0;
+
+    {
+        // We compile a path once. It is resolved to a sequence of attribute
+        // indices, which are then used for each evaluation.
+        auto path = cmoh::compile_path(accessors, "address.city.name", key_parser());
+        assert(path);
+        assert((path->indices() == std::vector<std::size_t>{1, 1, 0}));
+
+        auto name = path->get<std::string>(c);
+        std::cout << "City: " << name.value_or("unknown") << std::endl;
+        assert(name.has_value());
+        assert(*name == "Springfield");
+    }
+
+    {
+        // Values may also be visited without copying them. Since the type of
+        // the value is only known at run time, the visitor has to accept the
+        // values of all attributes.
+        auto path = cmoh::compile_path(accessors, "address.city.zip", key_parser());
+        assert(path);
+        zip_visitor visitor;
+        assert(path->visit(c, visitor));
+        std::cout << "ZIP: " << *visitor.zip << std::endl;
+        assert(visitor.zip == &c.get_address().get_city().zip);
+    }
+
+    // Intermediate objects were accessed via references
+    assert(address_copies == 0);
+
+    {
+        // Paths not addressing an attribute are rejected at compile time
+        assert(!cmoh::compile_path(accessors, "address.country", key_parser()));
+        assert(!cmoh::compile_path(accessors, "name.city", key_parser()));
+        assert(!cmoh::compile_path(accessors, "address.city.", key_parser()));
+        assert(!cmoh::compile_path(accessors, "", key_parser()));
+    }
+
+    {
+        // By default, keys are parsed as numbers
+        auto path = cmoh::compile_path(accessors, "1.0");
+        assert(path);
+        auto street = path->get<std::string>(c);
+        std::cout << "Street: " << street.value_or("unknown") << std::endl;
+        assert(street.has_value());
+        assert(*street == "Main Street 1");
+
+        // Incompatible types are treated like missing attributes
+        assert(!path->get<int>(c).has_value());
+
+        // Numbers which do not fit the key type are rejected rather than
+        // truncated to some other key
+        assert(!cmoh::compile_path(accessors, "4294967297.0"));
+        assert(!cmoh::compile_path(accessors, "18446744073709551617.0"));
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/encoding.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/patch.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+// Like in the attribute example, we declare a few attributes
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    person original = accessors.create<birthday, first_name, last_name>(
+        std::chrono::system_clock::now() - std::chrono::hours(24),
+        "Hans",
+        "Wurst"
+    );
+
+    // Imagine the original being replicated on another node
+    person replica = original;
+
+    // We change an attribute of the original and compute a patch, which
+    // contains only the changed attribute.
+    person changed = original;
+    accessors.set<first_name>(changed, "Henrick");
+    auto patch = accessors.diff(original, changed);
+    std::cout << "Patch size: " << patch.size() << " bytes" << std::endl;
+    assert(!patch.empty());
+
+    // The patch is transferred as bytes and applied to the replica
+    cmoh::patch received(patch.data(), patch.size());
+    assert(accessors.apply(replica, received));
+    assert(accessors.get<first_name>(replica) == "Henrick");
+    assert(accessors.get<last_name>(replica) == "Wurst");
+
+    // Identical objects yield an empty patch
+    assert(accessors.diff(changed, replica).empty());
+
+    // Truncated patches are detected
+    cmoh::patch truncated(patch.data(), patch.size() - 1);
+    assert(!accessors.apply(replica, truncated));
+
+    // Values are encoded via codecs, which also reject values which are
+    // malformed or do not fit their type
+    {
+        using cmoh::encoding::byte;
+        using cmoh::encoding::codec;
+
+        byte const invalid_bool[] = {2};
+        byte const* pos = invalid_bool;
+        bool flag;
+        assert(!codec<bool>::decode(pos, std::end(invalid_bool), flag));
+
+        byte const too_wide[] = {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02
+        };
+        pos = too_wide;
+        std::uint64_t raw;
+        assert(!cmoh::encoding::read_varint(pos, std::end(too_wide), raw));
+
+        std::vector<byte> buffer;
+        codec<int>::encode(buffer, 200);
+        pos = buffer.data();
+        std::int8_t narrow;
+        assert(!codec<std::int8_t>::decode(pos, pos + buffer.size(), narrow));
+        buffer.clear();
+        codec<unsigned>::encode(buffer, 300);
+        std::uint8_t unsigned_narrow;
+        pos = buffer.data();
+        assert(!codec<std::uint8_t>::decode(pos, pos + buffer.size(), unsigned_narrow));
+    }
+
+    return 0;
+}
+
@@ -33,6 +33,10 @@ void person::set_first_name(std::string const& name) { _first_name = name; }
 std::string person::last_name() const { return _last_name; }
 void person::set_last_name(std::string const& name) { _last_name = name; }
 
+std::chrono::system_clock::time_point person::birthday() const {
+    return _birthday;
+}
+
 std::chrono::hours person::age() const {
     auto const diff = decltype(_birthday)::clock::now() - _birthday;
     return std::chrono::duration_cast<std::chrono::hours>(diff);
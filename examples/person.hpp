@@ -41,12 +41,17 @@ public:
     person(person const&) = default;
     person(person&&) = default;
 
+    person& operator=(person const&) = default;
+    person& operator=(person&&) = default;
+
     std::string first_name() const;
     void set_first_name(std::string const& name);
 
     std::string last_name() const;
     void set_last_name(std::string const& name);
 
+    std::chrono::system_clock::time_point birthday() const;
+
     std::chrono::hours age() const;
 
 private:
@@ -0,0 +1,141 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/query.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+// Like in the attribute example, we declare a few attributes
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    // We create a few persons to query
+    auto const now = std::chrono::system_clock::now();
+    std::vector<person> people;
+    people.push_back(accessors.create<birthday, first_name, last_name>(
+        now - std::chrono::hours(10), "Hans", "Wurst"
+    ));
+    people.push_back(accessors.create<birthday, first_name, last_name>(
+        now - std::chrono::hours(20), "Lisa", "Wurst"
+    ));
+    people.push_back(accessors.create<birthday, first_name, last_name>(
+        now - std::chrono::hours(30), "Lisa", "Meier"
+    ));
+    people.push_back(accessors.create<birthday, first_name, last_name>(
+        now - std::chrono::hours(40), "Hans", "Meier"
+    ));
+
+    // A query is started from a bundle and a range of objects. We may filter
+    // the objects by their attributes' values...
+    auto adults = from(accessors, people).where<age>([] (std::chrono::hours value) {
+        return value > std::chrono::hours(15);
+    });
+    assert(adults.count() == 3);
+
+    // ... and select only some of the attributes. Both are evaluated in a
+    // single pass once we iterate over the result.
+    adults.where<last_name>([] (std::string const& value) {
+        return value == "Meier";
+    }).select<first_name, last_name>().for_each([] (auto const& names) {
+        std::cout << std::get<0>(names) << " " << std::get<1>(names) << std::endl;
+    });
+
+    // We can also aggregate values by groups, in this case the oldest age for
+    // each family.
+    auto oldest = adults.select<age>().group_by<last_name>(
+        std::chrono::hours(0),
+        [] (std::chrono::hours& acc, std::tuple<std::chrono::hours> value) {
+            acc = std::max(acc, std::get<0>(value));
+        }
+    );
+    for (auto const& group : oldest)
+        std::cout << group.first << ": " << group.second.count() << " hours" << std::endl;
+    assert(oldest.size() == 2);
+    assert(oldest["Wurst"] == std::chrono::hours(20));
+    assert(oldest["Meier"] == std::chrono::hours(40));
+
+    // Large sequences may be queried in parallel, in this case by up to four
+    // threads with at least 1024 persons each. For aggregating, the groups
+    // found by the individual threads are merged.
+    std::vector<person> crowd;
+    for (int i = 0; i < 10000; ++i)
+        crowd.push_back(accessors.create<birthday, first_name, last_name>(
+            now - std::chrono::hours(i % 100), "Hans", i % 3 ? "Wurst" : "Meier"
+        ));
+    cmoh::query::parallel const executor(4, 1024);
+    auto crowd_adults = from(accessors, crowd).where<age>([] (std::chrono::hours value) {
+        return value > std::chrono::hours(15);
+    });
+    assert(crowd_adults.count(executor) == crowd_adults.count());
+
+    auto const families = crowd_adults.select<age>().group_by<last_name>(
+        std::size_t(0),
+        [] (std::size_t& acc, std::tuple<std::chrono::hours>) { ++acc; },
+        [] (std::size_t& acc, std::size_t other) { acc += other; },
+        executor
+    );
+    assert(families.size() == 2);
+    assert(families.at("Wurst") + families.at("Meier") == crowd_adults.count());
+    assert(families.at("Meier") == crowd_adults.where<last_name>([] (std::string const& value) {
+        return value == "Meier";
+    }).count());
+
+    return 0;
+}
+
@@ -0,0 +1,134 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/registry.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+enum attribute {birthday, first_name, last_name, x, y};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using x_attr = cmoh::attribute<attribute, x, const int>;
+using y_attr = cmoh::attribute<attribute, y, const int>;
+
+
+class point {
+public:
+    point(int x, int y) : _x(x), _y(y) {}
+
+    int x() const { return _x; }
+    int y() const { return _y; }
+
+private:
+    int _x;
+    int _y;
+};
+
+
+// Bundles have to outlive the registry, hence we give them static storage
+// duration.
+static auto const person_accessors = bundle(
+    cmoh::factory<person, birthday_attr>(),
+    birthday_attr::accessor<person>(&person::birthday),
+    first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+    last_name_attr::accessor<person>(&person::last_name, &person::set_last_name)
+);
+
+static auto const point_accessors = bundle(
+    cmoh::factory<point, x_attr, y_attr>(),
+    x_attr::accessor<point>(&point::x),
+    y_attr::accessor<point>(&point::y)
+);
+
+
+
+
+int main(int argc, char* argv[]) {
+    // During startup, we register the types we want to handle, along with the
+    // attributes making up their payload. Afterwards, we freeze the registry.
+    auto& registry = cmoh::type_registry<attribute>::global();
+    assert((registry.add<birthday, first_name, last_name>("person", person_accessors)));
+    assert((registry.add<x, y>("point", point_accessors)));
+    assert(!(registry.add<x, y>("point", point_accessors)));
+    registry.freeze();
+    assert(!(registry.add<x, y>("another point", point_accessors)));
+
+    // A sender serializes objects without knowing which bundle to use...
+    std::vector<cmoh::encoding::byte> payload;
+    person hans(std::chrono::system_clock::now() - std::chrono::hours(48));
+    hans.set_first_name("Hans");
+    hans.set_last_name("Wurst");
+    assert(registry.serialize_any(hans, payload));
+    assert(registry.serialize_any(point(3, 4), payload));
+
+    // ... and a receiver creates them from a type name and the payload.
+    std::aligned_storage<sizeof(person), alignof(person)>::type person_storage;
+    std::aligned_storage<sizeof(point), alignof(point)>::type point_storage;
+
+    cmoh::encoding::byte const* pos = payload.data();
+    auto const end = payload.data() + payload.size();
+    auto p = static_cast<person*>(registry.create_by_name(
+        "person", std::strlen("person"), &person_storage, sizeof(person_storage), pos, end
+    ));
+    auto q = static_cast<point*>(registry.create_by_name(
+        "point", std::strlen("point"), &point_storage, sizeof(point_storage), pos, end
+    ));
+    assert(p && q && (pos == end));
+    assert((p->first_name() == "Hans") && (p->last_name() == "Wurst"));
+    assert(p->birthday() == hans.birthday());
+    assert((q->x() == 3) && (q->y() == 4));
+    std::cout << "Received " << p->first_name() << " and a point" << std::endl;
+
+    // Unknown types are rejected
+    auto const unknown = registry.find("unicorn");
+    assert(!unknown);
+
+    registry.find("person")->destroy(p);
+    registry.find(cmoh::tag_of<point>())->destroy(q);
+
+    return 0;
+}
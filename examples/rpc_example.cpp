@@ -0,0 +1,166 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/dispatcher.hpp>
+#include <cmoh/method.hpp>
+
+
+
+
+enum property {balance, owner, deposit, withdraw, change_owner};
+
+using balance_attr = cmoh::attribute<property, balance, const std::int64_t>;
+using owner_attr = cmoh::attribute<property, owner, const std::string>;
+using deposit_method = cmoh::method<property, deposit, std::int64_t(std::int64_t)>;
+using withdraw_method = cmoh::method<property, withdraw, bool(std::int64_t)>;
+using change_owner_method = cmoh::method<property, change_owner, void(std::string const&)>;
+
+
+class account {
+public:
+    std::int64_t balance() const { return _balance; }
+    std::string owner() const { return _owner; }
+
+    std::int64_t deposit(std::int64_t amount) {
+        _balance += amount;
+        return _balance;
+    }
+
+    bool withdraw(std::int64_t amount) {
+        if (amount > _balance)
+            return false;
+        _balance -= amount;
+        return true;
+    }
+
+    void change_owner(std::string const& owner) { _owner = owner; }
+
+private:
+    std::int64_t _balance = 0;
+    std::string _owner;
+};
+
+
+// A minimal in-process transport, looping requests back to a dispatcher
+template <
+    typename Dispatcher
+>
+struct loopback {
+    std::vector<cmoh::encoding::byte> request;
+    std::vector<cmoh::encoding::byte> response;
+
+    bool transfer(Dispatcher const& server, account& obj) {
+        cmoh::encoding::byte const* pos = request.data();
+        auto const end = request.data() + request.size();
+        response.clear();
+        while (pos != end)
+            if (!server.dispatch(obj, pos, end, response))
+                return false;
+        request.clear();
+        return true;
+    }
+};
+
+
+
+
+int main(int argc, char* argv[]) {
+    // Methods are bundled along with attributes
+    auto accessors = bundle(
+        balance_attr::accessor<account>(&account::balance),
+        owner_attr::accessor<account>(&account::owner),
+        deposit_method::accessor<account>(&account::deposit),
+        withdraw_method::accessor<account>(&account::withdraw),
+        change_owner_method::accessor<account>(&account::change_owner)
+    );
+    static_assert(decltype(accessors)::method_count == 3, "Unexpected method count");
+    static_assert(
+        decltype(accessors)::method_index<withdraw>() == 1,
+        "Unexpected method index"
+    );
+
+    // Methods may be invoked directly via the bundle
+    account acc;
+    assert(accessors.invoke<deposit>(acc, 100) == 100);
+    assert(!accessors.invoke<withdraw>(acc, 200));
+    accessors.invoke<change_owner>(acc, "Hans Wurst");
+    assert(accessors.get<owner>(acc) == "Hans Wurst");
+
+    // ... or via a dispatcher, which decodes calls from a buffer
+    auto server = cmoh::make_dispatcher(accessors);
+    typedef decltype(server) rpc_dispatcher;
+    loopback<rpc_dispatcher> transport;
+
+    rpc_dispatcher::encode_call<deposit>(transport.request, 23);
+    rpc_dispatcher::encode_call<withdraw>(transport.request, 3);
+    rpc_dispatcher::encode_call<change_owner>(transport.request, "Max Mustermann");
+    assert(transport.transfer(server, acc));
+    {
+        cmoh::encoding::byte const* pos = transport.response.data();
+        auto const end = transport.response.data() + transport.response.size();
+        std::int64_t new_balance;
+        bool withdrawn;
+        assert(rpc_dispatcher::decode_result<deposit>(pos, end, new_balance));
+        assert(rpc_dispatcher::decode_result<withdraw>(pos, end, withdrawn));
+        assert((new_balance == 123) && withdrawn && (pos == end));
+    }
+    assert(accessors.get<balance>(acc) == 120);
+    assert(accessors.get<owner>(acc) == "Max Mustermann");
+
+    // Calls of unknown methods are rejected
+    transport.request.push_back(42);
+    assert(!transport.transfer(server, acc));
+    transport.request.clear();
+
+    // Finally, we measure the rate of calls over the loopback transport
+    constexpr int calls = 1000000;
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        rpc_dispatcher::encode_call<deposit>(transport.request, 1);
+        transport.transfer(server, acc);
+    }
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - start;
+    assert(accessors.get<balance>(acc) == 120 + calls);
+
+    std::cout << "Dispatched " << static_cast<std::uint64_t>(calls/elapsed.count())
+        << " calls per second" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,333 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <iostream>
+
+#ifdef __linux__
+
+// std includes
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// POSIX includes
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/dispatcher.hpp>
+#include <cmoh/method.hpp>
+#include <cmoh/rpc/client.hpp>
+#include <cmoh/rpc/reactor.hpp>
+#include <cmoh/rpc/server.hpp>
+
+
+
+
+enum property {balance, deposit, withdraw};
+
+using balance_attr = cmoh::attribute<property, balance, const std::int64_t>;
+using deposit_method = cmoh::method<property, deposit, std::int64_t(std::int64_t)>;
+using withdraw_method = cmoh::method<property, withdraw, bool(std::int64_t)>;
+
+
+class account {
+public:
+    std::int64_t balance() const { return _balance; }
+
+    std::int64_t deposit(std::int64_t amount) {
+        _balance += amount;
+        return _balance;
+    }
+
+    bool withdraw(std::int64_t amount) {
+        if (amount > _balance)
+            return false;
+        _balance -= amount;
+        return true;
+    }
+
+private:
+    std::int64_t _balance = 0;
+};
+
+
+static auto const account_accessors = bundle(
+    balance_attr::accessor<account>(&account::balance),
+    deposit_method::accessor<account>(&account::deposit),
+    withdraw_method::accessor<account>(&account::withdraw)
+);
+
+typedef std::decay<decltype(account_accessors)>::type account_bundle;
+typedef cmoh::dispatcher<account_bundle> account_dispatcher;
+
+
+// The server runs in a separate process, serving a single account
+static
+int
+run_server(
+    int fd,
+    int batch_fd,
+    int latency_fd,
+    int shutdown_fd
+) {
+    account acc;
+    auto const dispatcher = cmoh::make_dispatcher(account_accessors);
+
+    cmoh::rpc::reactor reactor;
+    cmoh::rpc::server<account_dispatcher> server(reactor, dispatcher, acc);
+    if (!reactor.valid() || !server.serve(fd) || !server.serve(batch_fd) ||
+        !server.serve(latency_fd) || !server.serve(shutdown_fd))
+        return 1;
+
+    // the loop ends once the clients disconnect
+    return reactor.run() ? 0 : 1;
+}
+
+
+
+
+int main(int argc, char* argv[]) {
+    int fds[2];
+    int batch_fds[2];
+    int latency_fds[2];
+    int shutdown_fds[2];
+    assert(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+    assert(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, batch_fds) == 0);
+    assert(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, latency_fds) == 0);
+    assert(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, shutdown_fds) == 0);
+
+    auto const pid = ::fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        ::close(fds[0]);
+        ::close(batch_fds[0]);
+        ::close(latency_fds[0]);
+        ::close(shutdown_fds[0]);
+        ::_exit(run_server(fds[1], batch_fds[1], latency_fds[1], shutdown_fds[1]));
+    }
+    ::close(fds[1]);
+    ::close(batch_fds[1]);
+    ::close(latency_fds[1]);
+    ::close(shutdown_fds[1]);
+
+    auto const ignore = [] (
+        std::uint64_t,
+        bool success,
+        cmoh::encoding::byte const*,
+        cmoh::encoding::byte const*
+    ) { assert(success); };
+
+    {
+        cmoh::rpc::client<account_bundle> client(fds[0]);
+
+        // Calls are queued and sent at once. Responses carry the request id.
+        auto const first = client.call<deposit>(100);
+        auto const second = client.call<withdraw>(500);
+        assert(client.flush());
+
+        std::int64_t new_balance = 0;
+        bool withdrawn = true;
+        while (client.pending() > 0)
+            assert(client.receive([&] (
+                std::uint64_t id,
+                bool success,
+                cmoh::encoding::byte const* pos,
+                cmoh::encoding::byte const* end
+            ) {
+                assert(success);
+                if (id == first)
+                    assert(account_dispatcher::decode_result<deposit>(pos, end, new_balance));
+                if (id == second)
+                    assert(account_dispatcher::decode_result<withdraw>(pos, end, withdrawn));
+            }) > 0);
+        assert((new_balance == 100) && !withdrawn);
+
+        // We measure the latency of single calls...
+        constexpr int round_trips = 20000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < round_trips; ++i) {
+            client.call<deposit>(1);
+            assert(client.flush());
+            while (client.pending() > 0)
+                assert(client.receive(ignore) > 0);
+        }
+        std::chrono::duration<double, std::micro> const latency =
+            (std::chrono::steady_clock::now() - start) / round_trips;
+
+        // ... and the throughput with pipelined calls
+        constexpr int calls = 1000000;
+        constexpr int depth = 128;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; i += depth) {
+            for (int j = 0; j < depth; ++j)
+                client.call<deposit>(1);
+            assert(client.flush());
+            while (client.pending() > 0)
+                assert(client.receive(ignore) > 0);
+        }
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << "Round trip latency: " << latency.count() << " us" << std::endl;
+        std::cout << "Pipelined calls per second: "
+            << static_cast<std::uint64_t>(calls/elapsed.count()) << std::endl;
+    }
+
+    {
+        // Calls may also be coalesced into batches, which are sent once they
+        // are full.
+        cmoh::rpc::batch_options options;
+        options.coalesce = true;
+        options.batch_size = 64;
+        options.queue_depth = 256;
+        cmoh::rpc::client<account_bundle> client(batch_fds[0], options);
+
+        // Responses to a batch are received one by one, in order. Each carries
+        // the id returned by the corresponding call.
+        std::vector<std::uint64_t> ids;
+        std::size_t handled = 0;
+        std::int64_t previous = -1;
+        auto const check = [&] (
+            std::uint64_t id,
+            bool success,
+            cmoh::encoding::byte const* pos,
+            cmoh::encoding::byte const* end
+        ) {
+            assert(handled < ids.size());
+            assert((id == ids[handled]) && (id == ids.front() + handled));
+            ++handled;
+
+            std::int64_t new_balance;
+            assert(success);
+            assert(account_dispatcher::decode_result<deposit>(pos, end, new_balance));
+            assert((previous < 0) || (new_balance == previous + 1));
+            previous = new_balance;
+        };
+        for (int i = 0; i < 10; ++i)
+            ids.push_back(client.call<deposit>(1));
+        assert((client.queued() == 10) && (client.pending() == 10));
+        while (client.pending() > 0)
+            assert(client.receive(check) > 0);
+        assert(handled == ids.size());
+
+        // Once the queue depth is reached, calls are rejected
+        for (std::size_t i = 0; i < options.queue_depth; ++i) {
+            ids.push_back(client.call<deposit>(1));
+            assert(ids.back() != client.busy);
+        }
+        assert(client.call<deposit>(1) == client.busy);
+        while (client.pending() > 0)
+            assert(client.receive(check) > 0);
+        assert(handled == ids.size());
+
+        constexpr int calls = 1000000;
+        auto const start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i)
+            while (client.call<deposit>(1) == client.busy)
+                assert(client.receive(ignore) > 0);
+        while (client.pending() > 0)
+            assert(client.receive(ignore) > 0);
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << "Batched calls per second: "
+            << static_cast<std::uint64_t>(calls/elapsed.count()) << std::endl;
+    }
+
+    {
+        // Batches may also be sent once the oldest call was queued for too
+        // long. With a latency of zero, each call is sent right away.
+        cmoh::rpc::batch_options options;
+        options.coalesce = true;
+        options.flush_latency = cmoh::rpc::batch_options::clock::duration::zero();
+        cmoh::rpc::client<account_bundle> client(latency_fds[0], options);
+
+        assert(client.call<deposit>(1) != client.failed);
+        assert((client.queued() == 0) && (client.pending() == 1));
+        while (client.pending() > 0)
+            assert(client.receive(ignore) > 0);
+    }
+
+    {
+        // Responses pending when the client shuts down its side of the
+        // connection are still sent before the server closes it.
+        cmoh::rpc::client<account_bundle> client(shutdown_fds[0]);
+        constexpr int calls = 100000;
+        for (int i = 0; i < calls; ++i)
+            client.call<deposit>(1);
+        assert(client.flush());
+        assert(::shutdown(shutdown_fds[0], SHUT_WR) == 0);
+
+        int received = 0;
+        while (client.pending() > 0) {
+            auto const count = client.receive(ignore);
+            assert(count > 0);
+            received += count;
+        }
+        assert(received == calls);
+    }
+
+    {
+        // If calls can not be sent, the connection is broken. The calls are
+        // not counted as pending, since they will never be answered.
+        int broken_fds[2];
+        assert(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, broken_fds) == 0);
+        ::close(broken_fds[1]);
+
+        cmoh::rpc::client<account_bundle> client(broken_fds[0]);
+        client.call<deposit>(1);
+        assert(!client.flush());
+        assert(client.broken() && (client.pending() == 0));
+        assert(client.call<deposit>(1) == client.failed);
+        assert(client.receive(ignore) < 0);
+    }
+
+    int status;
+    assert(::waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+    // The reactor is only available on Linux. Signal a skipped test.
+    std::cout << "Skipped" << std::endl;
+    return 77;
+}
+
+#endif
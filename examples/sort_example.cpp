@@ -0,0 +1,156 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/sort.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+// Like in the attribute example, we declare a few attributes
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+// A plain measurement, of which we sort plenty
+enum measurement_attribute {value};
+
+using value_attr = cmoh::attribute<measurement_attribute, value, double>;
+
+struct measurement {
+    double value;
+    std::size_t sequence;
+};
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    // We create a bunch of persons with scrambled ages and names
+    static const char* names[] = {"Wurst", "Meier", "Mueller", "Schmidt", "Wu"};
+    auto const now = std::chrono::system_clock::now();
+    std::vector<person> people;
+    for (int i = 0; i < 200; ++i)
+        people.push_back(accessors.create<birthday, last_name>(
+            now - std::chrono::hours((i*37) % 200 + 1),
+            names[i % 5]
+        ));
+
+    // Sorting by an attribute extracts each value only once. For durations,
+    // like the age, a radix sort is used.
+    accessors.sort_by<age>(people);
+    for (std::size_t i = 1; i < people.size(); ++i)
+        assert(accessors.get<age>(people[i - 1]) <= accessors.get<age>(people[i]));
+    std::cout << "Youngest: " << accessors.get<age>(people.front()).count() << " hours" << std::endl;
+    std::cout << "Oldest: " << accessors.get<age>(people.back()).count() << " hours" << std::endl;
+
+    // Strings are sorted using cached prefixes. Sorting is stable, so persons
+    // with the same name are still ordered by their age.
+    accessors.sort_by<last_name>(people.begin(), people.end());
+    for (std::size_t i = 1; i < people.size(); ++i) {
+        auto const& prev = people[i - 1];
+        auto const& current = people[i];
+        assert(accessors.get<last_name>(prev) <= accessors.get<last_name>(current));
+        if (accessors.get<last_name>(prev) == accessors.get<last_name>(current))
+            assert(accessors.get<age>(prev) <= accessors.get<age>(current));
+    }
+    std::cout << "First: " << accessors.get<last_name>(people.front()) << std::endl;
+    std::cout << "Last: " << accessors.get<last_name>(people.back()) << std::endl;
+
+    // Large sequences are sorted by multiple threads. Negative zero sorts like
+    // zero and NaNs end up last, in their original order.
+    auto measurements = cmoh::bundle(
+        value_attr::accessor<measurement>(offsetof(measurement, value))
+    );
+    auto const nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<measurement> samples;
+    for (std::size_t i = 0; i < 4*cmoh::sort::parallel_threshold; ++i) {
+        double const values[] = {0., -0., nan, -static_cast<double>(i % 1000)};
+        samples.push_back(measurement{values[i % 7 % 4], i});
+    }
+    measurements.sort_by<value>(samples);
+    for (std::size_t i = 1; i < samples.size(); ++i) {
+        auto const& prev = samples[i - 1];
+        auto const& current = samples[i];
+        if (std::isnan(current.value)) {
+            assert(!std::isnan(prev.value) || (prev.sequence < current.sequence));
+            continue;
+        }
+        assert(!std::isnan(prev.value) && (prev.value <= current.value));
+        if (prev.value == current.value)
+            assert(prev.sequence < current.sequence);
+    }
+    std::cout << "Sorted " << samples.size() << " measurements" << std::endl;
+
+    // The permutation may also be computed directly, using a specific number
+    // of threads regardless of the hardware.
+    std::vector<measurement> shuffled;
+    for (std::size_t i = 0; i < 4*cmoh::sort::parallel_threshold; ++i)
+        shuffled.push_back(measurement{static_cast<double>((i*7919) % 1000), i});
+    auto const perm = cmoh::sort::permutation<double>(
+        shuffled.size(),
+        [&] (std::size_t index) { return shuffled[index].value; },
+        4
+    );
+    for (std::size_t i = 1; i < perm.size(); ++i) {
+        auto const& prev = shuffled[perm[i - 1]];
+        auto const& current = shuffled[perm[i]];
+        assert(prev.value <= current.value);
+        if (prev.value == current.value)
+            assert(prev.sequence < current.sequence);
+    }
+
+    return 0;
+}
+
@@ -96,6 +96,10 @@ int main(int argc, char* argv[]) {
     assert(accessors.set<std::string>(p, std::string("first_name"), "Henrick"));
     accessors.visit_properties(printer);
 
+    // Indices of attributes are looked up by the contents of the string
+    assert(accessors.key_at(accessors.index_of(cmoh::string_view("last_name"))) == last_name);
+    assert(accessors.index_of(cmoh::string_view("height")) == accessors.npos);
+
     return 0;
 }
 
@@ -0,0 +1,132 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+#include <cmoh/patch.hpp>
+#include <cmoh/tracked.hpp>
+
+// local includes
+#include "person.hpp"
+
+
+
+
+// Like in the attribute example, we declare a few attributes
+enum attribute {birthday, first_name, last_name, age};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+
+
+// A sensor's reading is accessible both as a number and as text
+enum sensor_attribute {reading};
+
+using raw_reading_attr = cmoh::attribute<sensor_attribute, reading, int>;
+using text_reading_attr = cmoh::attribute<sensor_attribute, reading, std::string>;
+
+struct sensor {
+    int raw() const { return value; }
+    void set_raw(int const& raw) { value = raw; }
+
+    std::string text() const { return std::to_string(value); }
+    void set_text(std::string const& text) { value = std::stoi(text); }
+
+    int value = 0;
+};
+
+
+
+
+int main(int argc, char* argv[]) {
+    auto accessors = bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    person original = accessors.create<birthday, first_name, last_name>(
+        std::chrono::system_clock::now() - std::chrono::hours(24),
+        "Hans",
+        "Wurst"
+    );
+    person replica = original;
+
+    // We start tracking modifications of an object. The dirty flags of all
+    // the attributes fit into a single byte.
+    auto tracked = cmoh::track(accessors, original);
+    static_assert(sizeof(tracked.dirty()) == 1, "Unexpected dirty set size");
+    assert(!tracked.modified());
+
+    // Setting attributes through the tracked object marks them as dirty, both
+    // with static and dynamic keys.
+    tracked.set<first_name>("Henrick");
+    assert(tracked.is_dirty<first_name>());
+    assert(!tracked.is_dirty<last_name>());
+    assert(tracked.set<std::string>(last_name, "Meier"));
+    assert(tracked.is_dirty<last_name>());
+
+    tracked.visit_dirty([] (auto accessor) {
+        std::cout << "Dirty: " << cmoh::accessors::key(accessor) << std::endl;
+    });
+
+    // Flushing serializes only the dirty attributes. Using a patch, we can
+    // bring the replica up to date.
+    cmoh::patch patch;
+    tracked.flush(patch);
+    assert(!tracked.modified());
+    assert(accessors.apply(replica, patch));
+    assert(accessors.get<first_name>(replica) == "Henrick");
+    assert(accessors.get<last_name>(replica) == "Meier");
+
+    // With dynamic keys, the attribute marked dirty is the one which was set,
+    // even if several attributes share the key.
+    auto sensors = bundle(
+        raw_reading_attr::accessor<sensor>(&sensor::raw, &sensor::set_raw),
+        text_reading_attr::accessor<sensor>(&sensor::text, &sensor::set_text)
+    );
+    auto tracked_sensor = cmoh::track(sensors, sensor());
+    assert(tracked_sensor.set<std::string>(reading, std::string("42")));
+    assert(tracked_sensor.dirty() == 2);
+    assert(tracked_sensor.set<int>(reading, 23));
+    assert(tracked_sensor.dirty() == 3);
+
+    return 0;
+}
+
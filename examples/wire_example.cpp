@@ -0,0 +1,114 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+
+
+
+
+// Records as they are sent over the network or stored in a mapped file. The
+// struct consists of bytes only. Hence, it has an alignment of one and may be
+// overlaid on a buffer at any position.
+struct record {
+    unsigned char bytes[15];
+};
+
+static_assert(alignof(record) == 1, "Record is not overlayable");
+
+
+enum attribute {kind, sequence, timestamp, temperature};
+
+using kind_attr = cmoh::attribute<attribute, kind, unsigned int>;
+using sequence_attr = cmoh::attribute<attribute, sequence, std::uint16_t>;
+using timestamp_attr = cmoh::attribute<attribute, timestamp, std::uint64_t>;
+using temperature_attr = cmoh::attribute<attribute, temperature, float>;
+
+
+
+
+int main(int argc, char* argv[]) {
+    // The values are located at fixed offsets, most of them unaligned, and are
+    // stored in big endian byte order except for the temperature. For each of
+    // them, we supply the type and the location via a `cmoh::wire_offset`.
+    auto accessors = bundle(
+        kind_attr::accessor<record, std::uint8_t>(cmoh::wire_offset<0>()),
+        sequence_attr::accessor<record, std::uint16_t>(
+            cmoh::wire_offset<1, cmoh::byte_order::big>()
+        ),
+        timestamp_attr::accessor<record, std::uint64_t>(
+            cmoh::wire_offset<3, cmoh::byte_order::big>()
+        ),
+        temperature_attr::accessor<record, float>(
+            cmoh::wire_offset<11, cmoh::byte_order::little>()
+        )
+    );
+
+    // A buffer holding two records, the second one starting at an odd address
+    std::vector<unsigned char> buffer = {
+        0x01, 0x00, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x5a, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x28, 0x42,
+        0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5a, 0x00, 0x00, 0x02,
+        0x00, 0x00, 0x48, 0xc1,
+    };
+
+    // We read the records in place, without decoding them first
+    auto records = reinterpret_cast<record*>(buffer.data());
+    for (std::size_t i = 0; i < 2; ++i)
+        std::cout << "Record " << accessors.get<sequence>(records[i])
+            << ": kind " << accessors.get<kind>(records[i])
+            << ", time " << accessors.get<timestamp>(records[i])
+            << ", temperature " << accessors.get<temperature>(records[i])
+            << std::endl;
+
+    assert(accessors.get<kind>(records[0]) == 1);
+    assert(accessors.get<sequence>(records[0]) == 42);
+    assert(accessors.get<timestamp>(records[0]) == 0x5a000001ull);
+    assert(accessors.get<temperature>(records[0]) == 42.f);
+    assert(accessors.get<sequence>(records[1]) == 256);
+    assert(accessors.get<temperature>(records[1]) == -12.5f);
+
+    // Values are written back in the record's byte order
+    accessors.set<sequence>(records[1], 0x1234);
+    assert((buffer[16] == 0x12) && (buffer[17] == 0x34));
+    accessors.set<temperature>(records[1], 42.f);
+    assert((buffer[28] == 0x28) && (buffer[29] == 0x42));
+
+    // Dynamic access works like with any other accessor
+    assert(accessors.get<std::uint64_t>(records[1], timestamp).value_or(0) ==
+        0x5a000002ull);
+
+    return 0;
+}
@@ -26,6 +26,12 @@
 
 
 // std includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <type_traits>
 #include <utility>
 
@@ -40,6 +46,36 @@
 namespace cmoh {
 
 
+// defined in <cmoh/patch.hpp>, which has to be included for patching objects
+class patch;
+
+
+namespace sort {
+
+
+// defined in <cmoh/sort.hpp>, which has to be included for sorting objects
+template <
+    typename Value,
+    typename
+>
+struct sorter;
+
+
+}
+namespace hashing {
+
+
+// defined in <cmoh/hash.hpp>, which has to be included for hashing objects
+template <
+    typename Value,
+    typename
+>
+struct hasher;
+
+
+}
+
+
 /**
  * Accessor bundle
  *
@@ -93,248 +129,2005 @@ public:
     >::type;
 
 
-    accessor_bundle(Accessors... accessors) :
-            _accessors(std::forward<Accessors>(accessors)...) {}
-    accessor_bundle(accessor_bundle const&) = default;
-    accessor_bundle(accessor_bundle&&) = default;
-    accessor_bundle() = delete;
-
+private:
+    /**
+     * Check whether an attribute may be set after construction
+     */
+    template <
+        key_type key ///< key of the attribute
+    >
+    using is_settable_key = util::disjunction<
+        util::conjunction<
+            cmoh::accessors::is_settable<Accessors>,
+            cmoh::accessors::accesses<Accessors, key_type, key>
+        >...
+    >;
 
     /**
-     * Set the value of a specific attribute on an object
+     * Cost of creating an object from some attributes via an accessor
+     *
+     * For factories initializable from the attributes identified by `keys`,
+     * the cost is the number of those attributes the factory does not use,
+     * each of which has to be set after construction, plus the cost declared
+     * by the factory. For all other accessors, including factories which don't
+     * use an attribute which cannot be set, the cost is the maximum value.
      */
     template <
-        key_type ...keys ///< keys of attributes from which to construct an object
+        typename Accessor, ///< accessor for which to compute the cost
+        key_type ...keys ///< keys of the attributes supplied
     >
-    object_type
-    create(
-        typename property_by_key<keys>::type&&... values ///< values to use
-    ) const {
-        auto factory = _accessors.template get<
-            cmoh::accessors::is_initializable_from<
-                Accessors,
-                key_type,
-                keys...
-            >...
-        >();
+    struct construction_cost {
+    private:
+        template <
+            typename Factory,
+            typename = void
+        >
+        struct helper :
+            std::integral_constant<std::size_t, static_cast<std::size_t>(-1)> {};
 
-        // construct the object itself
-        auto retval{factory.template create<property_by_key<keys>...>(
-            std::forward<typename property_by_key<keys>::type>(values)...
-        )};
+        template <
+            typename Factory
+        >
+        struct helper<
+            Factory,
+            typename std::enable_if<
+                cmoh::accessors::is_initializable_from<
+                    Factory,
+                    key_type,
+                    keys...
+                >::value &&
+                util::conjunction<std::integral_constant<
+                    bool,
+                    Factory::template uses<keys>::value || is_settable_key<keys>::value
+                >...>::value
+            >::type
+        > : std::integral_constant<
+            std::size_t,
+            cmoh::accessors::declared_cost<Factory>::value +
+            util::count_if<
+                std::integral_constant<bool, !Factory::template uses<keys>::value>...
+            >::value
+        > {};
 
-        initialize_if_unused<decltype(factory), keys...>(
-            retval,
-            std::forward<typename property_by_key<keys>::type>(values)...
-        );
+    public:
+        static constexpr std::size_t value = helper<Accessor>::value;
+    };
+
+    /**
+     * Index of the cheapest factory for creating an object from attributes
+     *
+     * Of several factories with the same cost, the first one is selected.
+     */
+    template <
+        key_type ...keys ///< keys of the attributes supplied
+    >
+    static
+    constexpr
+    std::size_t
+    cheapest_factory() noexcept {
+        constexpr std::size_t costs[] = {
+            construction_cost<Accessors, keys...>::value...
+        };
 
+        std::size_t retval = 0;
+        for (std::size_t i = 1; i < sizeof...(Accessors); ++i)
+            if (costs[i] < costs[retval])
+                retval = i;
         return retval;
     }
 
+    /**
+     * Selection of the factory used for creating an object from attributes
+     *
+     * Provides the factory via the member `type` and the static method `get()`.
+     */
+    template <
+        typename Indices, ///< index sequence for the accessors
+        key_type ...keys ///< keys of the attributes supplied
+    >
+    struct factory_selector;
+
+    template <
+        std::size_t ...indices,
+        key_type ...keys
+    >
+    struct factory_selector<std::index_sequence<indices...>, keys...> {
+        static_assert(
+            util::disjunction<std::integral_constant<
+                bool,
+                construction_cost<Accessors, keys...>::value !=
+                    static_cast<std::size_t>(-1)
+            >...>::value,
+            "No factory suitable for creating an object from the attributes supplied"
+        );
+
+        typedef typename accessors::template type_of<
+            std::integral_constant<bool, indices == cheapest_factory<keys...>()>...
+        > type;
+
+        static
+        type const&
+        get(
+            accessors const& items
+        ) noexcept {
+            return items.template get<
+                std::integral_constant<bool, indices == cheapest_factory<keys...>()>...
+            >();
+        }
+    };
 
     /**
-     * Get the value of a specific attribute from an object
+     * Check whether an accessor's attribute is set after construction
+     */
+    template <
+        typename Factory, ///< factory used for construction
+        typename Accessor, ///< accessor to check
+        key_type ...keys ///< keys of the attributes supplied
+    >
+    using set_after_construction = util::disjunction<
+        util::conjunction<
+            cmoh::accessors::accesses<Accessor, key_type, keys>,
+            std::integral_constant<bool, !Factory::template uses<keys>::value>
+        >...
+    >;
+
+
+public:
+    /**
+     * Get the factory used for creating an object from specific attributes
      *
-     * \returns the value of the attribute
+     * Of all factories which can create an object from the attributes
+     * identified by `keys`, the one requiring the fewest attributes to be set
+     * after construction is selected. The cost declared by factories, e.g.
+     * via `cmoh::with_cost()`, is added to that number.
      */
     template <
-        key_type key ///< key of attribute to get
+        key_type ...keys ///< keys of the attributes supplied
     >
-    typename property_by_key<key>::type
-    get(
-        object_type const& obj ///< object from which to get the value
-    ) const {
-        return _accessors.template get<
-            cmoh::accessors::accesses<Accessors, key_type, key>...
-        >().get(obj);
+    using factory_for = typename factory_selector<
+        std::make_index_sequence<sizeof...(Accessors)>,
+        keys...
+    >::type;
+
+    /**
+     * Get the number of attributes set after construction
+     *
+     * \returns the number of attributes identified by `keys` which are set
+     *          via setters when creating an object from those attributes
+     */
+    template <
+        key_type ...keys ///< keys of the attributes supplied
+    >
+    static
+    constexpr
+    std::size_t
+    setter_count() noexcept {
+        return util::count_if<std::integral_constant<
+            bool,
+            !factory_for<keys...>::template uses<keys>::value
+        >...>::value;
     }
 
     /**
-     * Set the value of a specific attribute on an object
+     * Call a function with the accessor of every attribute set after creation
+     *
+     * The function is called with each of the accessors used for setting the
+     * attributes identified by `keys` after an object is constructed from
+     * them, i.e. with those attributes not used by the factory selected.
+     * The attribute's key may be retrieved via `cmoh::accessors::key()`.
      */
     template <
-        key_type key ///< key of attribute to set
+        key_type ...keys, ///< keys of the attributes supplied
+        typename Function ///< type of the function to call
     >
     void
-    set(
-        object_type& obj, ///< object on which to set the attribute
-        typename property_by_key<key>::type&& value ///< value to set
+    visit_setters(
+        Function&& function ///< function to call
     ) const {
-        _accessors.template get<
-            cmoh::accessors::accesses<Accessors, key_type, key>...
-        >().set(obj, std::forward<typename property_by_key<key>::type>(value));
+        _accessors.template visit<
+            Function&,
+            std::integral_constant<
+                bool,
+                cmoh::accessors::is_settable<Accessors>::value &&
+                set_after_construction<
+                    factory_for<keys...>,
+                    Accessors,
+                    keys...
+                >::value
+            >...
+        >(function);
     }
 
 
     /**
-     * Get the value of a specific attribute from an object
+     * Number of settable attributes accessible via the bundle
+     */
+    static constexpr std::size_t settable_count = util::count_if<
+        cmoh::accessors::is_settable<Accessors>...
+    >::value;
+
+    /**
+     * Get the index of a settable attribute
      *
-     * \returns the value of the attribute
+     * Settable attributes are numbered consecutively in the order of their
+     * accessors, starting at zero. These indices are used e.g. in patches.
+     *
+     * \returns the index of the attribute with the key `key`
      */
     template <
-        typename Type, ///< type of the attribute to get
-        typename KeyType = key_type ///< key type to use
+        key_type key ///< key of the attribute
     >
-    optional<Type>
-    get(
-        object_type const& obj, ///< object from which to get the value
-        KeyType&& key ///< key of the attribute to get
-    ) const {
-        optional<Type> retval;
+    static
+    constexpr
+    std::size_t
+    settable_index() noexcept {
+        static_assert(
+            util::disjunction<
+                util::conjunction<
+                    cmoh::accessors::is_settable<Accessors>,
+                    cmoh::accessors::accesses<Accessors, key_type, key>
+                >...
+            >::value,
+            "No settable attribute with the key supplied"
+        );
 
-        visit_attributes<Type>([&] (auto accessor) {
-            if (!(cmoh::accessors::key(accessor) == key))
-                return;
-            retval = accessor.get(obj);
-        });
+        constexpr bool settable[] = {
+            cmoh::accessors::is_settable<Accessors>::value...
+        };
+        constexpr bool matches[] = {
+            cmoh::accessors::accesses<Accessors, key_type, key>::value...
+        };
 
+        std::size_t retval = 0;
+        for (std::size_t i = 0; !(settable[i] && matches[i]); ++i)
+            if (settable[i])
+                ++retval;
         return retval;
     }
 
+
+private:
     /**
-     * Set the value of a specific attribute on an object
+     * Get the number of method accessors preceding an accessor
      */
-    template <
-        typename Type, ///< type of the attribute to get
-        typename KeyType = key_type ///< key type to use
-    >
-    bool
-    set(
-        object_type& obj, ///< object on which to set the attribute
-        KeyType&& key, ///< key of the attribute to get
-        Type&& value ///< value to set
-    ) const {
-        bool retval = false;
-
-        visit_attributes<Type>([&] (auto accessor) {
-            if (!(cmoh::accessors::key(accessor) == key))
-                return;
-            accessor.set(obj, std::forward<Type>(value));
-            retval = true;
-        });
+    static
+    constexpr
+    std::size_t
+    method_rank(
+        std::size_t index ///< index of the accessor
+    ) noexcept {
+        constexpr bool methods[] = {
+            cmoh::accessors::is_method_accessor<Accessors>::value...
+        };
 
+        std::size_t retval = 0;
+        for (std::size_t i = 0; i < index; ++i)
+            if (methods[i])
+                ++retval;
         return retval;
     }
 
-
     /**
-     * Calls a function with every accessor accessing a property
+     * Selection of the accessor of a method by its index
      *
-     * This method applies the function supplied on every accessor which
-     * accesses a single property. The function will be calles with the
-     * accessors as the only argument.
+     * Provides the accessor via the member `type` and the static method
+     * `get()`.
      */
     template <
-        typename Function
+        typename Indices, ///< index sequence for the accessors
+        std::size_t id ///< index of the method
     >
-    void
-    visit_properties(
-        Function&& function
-    ) const {
-        _accessors.template visit<
-            Function,
+    struct method_selector;
+
+    template <
+        std::size_t ...indices,
+        std::size_t id
+    >
+    struct method_selector<std::index_sequence<indices...>, id> {
+        static_assert(
+            id < util::count_if<
+                cmoh::accessors::is_method_accessor<Accessors>...
+            >::value,
+            "No method with the index supplied"
+        );
+
+        typedef typename accessors::template type_of<
             std::integral_constant<
                 bool,
-                !std::is_same<
-                    typename cmoh::accessors::property<Accessors>::type,
-                    void
-                >::value
+                cmoh::accessors::is_method_accessor<Accessors>::value &&
+                (method_rank(indices) == id)
             >...
-        >(std::forward<Function>(function));
-    }
+        > type;
 
+        static
+        type const&
+        get(
+            accessors const& items
+        ) noexcept {
+            return items.template get<
+                std::integral_constant<
+                    bool,
+                    cmoh::accessors::is_method_accessor<Accessors>::value &&
+                    (method_rank(indices) == id)
+                >...
+            >();
+        }
+    };
 
-private:
+
+public:
     /**
-     * Initialize attributes which are not used by a specific constructor
+     * Number of methods accessible via the bundle
+     */
+    static constexpr std::size_t method_count = util::count_if<
+        cmoh::accessors::is_method_accessor<Accessors>...
+    >::value;
+
+    /**
+     * Get the index of a method
+     *
+     * Methods are numbered consecutively in the order of their accessors,
+     * starting at zero. These indices are used e.g. by dispatchers.
+     *
+     * \returns the index of the method with the key `key`
      */
     template <
-        typename Constructor, ///< constructor to consider
-        key_type key0, ///< first of the attributes' keys
-        key_type ...keys ///< rest of the attributes' keys
+        key_type key ///< key of the method
     >
-    void
-    initialize_if_unused(
-        object_type& obj, ///< object on which to set the attributes' values
-        typename property_by_key<key0>::type&& value0, ///< first of the values
-        typename property_by_key<keys>::type&&... values ///< rest of the values
-    ) const {
-        initialize_single_if_unused<Constructor, key0>(
-            obj,
-            std::forward<typename property_by_key<key0>::type>(value0)
+    static
+    constexpr
+    std::size_t
+    method_index() noexcept {
+        static_assert(
+            util::disjunction<
+                util::conjunction<
+                    cmoh::accessors::is_method_accessor<Accessors>,
+                    cmoh::accessors::accesses<Accessors, key_type, key>
+                >...
+            >::value,
+            "No method with the key supplied"
         );
 
-        // recurse
-        initialize_if_unused<Constructor, keys...>(
-            obj,
-            std::forward<typename property_by_key<keys>::type>(values)...
-        );
+        constexpr bool methods[] = {
+            cmoh::accessors::is_method_accessor<Accessors>::value...
+        };
+        constexpr bool matches[] = {
+            cmoh::accessors::accesses<Accessors, key_type, key>::value...
+        };
+
+        std::size_t retval = 0;
+        for (std::size_t i = 0; !(methods[i] && matches[i]); ++i)
+            if (methods[i])
+                ++retval;
+        return retval;
     }
 
-    // overload for an empty list of attributes
+    /**
+     * Get the type of the accessor of the method with a specific index
+     */
     template <
-        typename Constructor
+        std::size_t id ///< index of the method
     >
-    void
-    initialize_if_unused(
-        object_type& obj
-    ) const {}
-
+    using method_accessor = typename method_selector<
+        std::make_index_sequence<sizeof...(Accessors)>,
+        id
+    >::type;
 
     /**
-     * Initialize a single attribute if it is not used by a specific constructor
+     * Get the accessor of the method with a specific index
+     *
+     * \returns the accessor of the method with the index `id`
      */
     template <
-        typename Constructor, ///< constructor to consider
-        key_type key ///< attribute to set
+        std::size_t id ///< index of the method
     >
-    typename std::enable_if<
-        !Constructor::template uses<key>::value
-    >::type
-    initialize_single_if_unused(
-        object_type& obj, ///< object on which to set the attribute's value
-        typename property_by_key<key>::type&& value ///< value to set
-    ) const {
-        // TODO: static assertion for unsettable attributes
-        set<key>(obj, std::forward<typename property_by_key<key>::type>(value));
+    method_accessor<id> const&
+    method_at() const noexcept {
+        return method_selector<
+            std::make_index_sequence<sizeof...(Accessors)>,
+            id
+        >::get(_accessors);
     }
 
-    // overload for attributes which are used by the constructor specified
+
+    /**
+     * Number of attributes accessible via the bundle
+     */
+    static constexpr std::size_t attribute_count = util::count_if<
+        cmoh::accessors::is_attribute_accessor<Accessors>...
+    >::value;
+
+    /**
+     * Value returned by `index_of()` for keys not known to the bundle
+     */
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * Get the index of an attribute
+     *
+     * Attributes are numbered consecutively in the order of their accessors,
+     * starting at zero. Hence, the indices are dense and may be used e.g. for
+     * indexing arrays of `attribute_count` elements. They coincide with the
+     * ids used by `cmoh::dynamic_bundle`.
+     *
+     * \returns the index of the attribute with the key `key`
+     */
     template <
-        typename Constructor,
-        key_type key
+        key_type key ///< key of the attribute
     >
-    typename std::enable_if<
-        Constructor::template uses<key>::value
-    >::type
-    initialize_single_if_unused(
-        object_type& obj,
-        typename property_by_key<key>::type&& value
-    ) const {}
+    static
+    constexpr
+    std::size_t
+    index_of() noexcept {
+        static_assert(
+            util::disjunction<
+                util::conjunction<
+                    cmoh::accessors::is_attribute_accessor<Accessors>,
+                    cmoh::accessors::accesses<Accessors, key_type, key>
+                >...
+            >::value,
+            "No attribute with the key supplied"
+        );
+
+        constexpr bool attributes[] = {
+            cmoh::accessors::is_attribute_accessor<Accessors>::value...
+        };
+        constexpr bool matches[] = {
+            cmoh::accessors::accesses<Accessors, key_type, key>::value...
+        };
 
+        std::size_t retval = 0;
+        for (std::size_t i = 0; !(attributes[i] && matches[i]); ++i)
+            if (attributes[i])
+                ++retval;
+        return retval;
+    }
 
+    /**
+     * Get the index of an attribute given at run time
+     *
+     * The index is looked up in a hash table, which is built on first use.
+     * The table's size is fixed at compile time, hence no memory is
+     * allocated.
+     *
+     * \returns the index of the attribute with the key `key` or `npos`, if
+     *          there is no such attribute
+     */
     template <
-        typename Type,
-        typename Function
+        typename KeyType ///< key type to use
     >
-    void
-    visit_attributes(
-        Function&& function
+    std::size_t
+    index_of(
+        KeyType const& key ///< key of the attribute
     ) const {
-        _accessors.template visit<
-            Function,
-            std::is_convertible<
-                typename properties::type_of_attribute<
-                    typename cmoh::accessors::property<Accessors>::type
-                >::type,
-                Type
-            >...
-        >(std::forward<Function>(function));
+        static index_table const table(*this);
+        return table.find(key);
     }
 
-
-    accessors _accessors;
-};
+    /**
+     * Get the key of the attribute with a specific index
+     *
+     * The index must be less than `attribute_count`.
+     *
+     * \returns the key of the attribute with the index `index`
+     */
+    typename std::decay<key_type>::type
+    key_at(
+        std::size_t index ///< index of the attribute
+    ) const {
+        typename std::decay<key_type>::type retval{};
+        visit_attribute_at(index, [&retval] (auto const& accessor) {
+            retval = cmoh::accessors::key(accessor);
+        });
+        return retval;
+    }
+
+    /**
+     * Call a function with the accessor of the attribute with a specific index
+     *
+     * The accessor is reached via a table generated at compile time.
+     *
+     * \returns true if the function was called, false if there is no
+     *          attribute with the index supplied
+     */
+    template <
+        typename Function ///< type of the function to apply
+    >
+    bool
+    visit_attribute_at(
+        std::size_t index, ///< index of the attribute
+        Function&& function ///< function to apply
+    ) const {
+        return _accessors.template visit_at<
+            Function&,
+            cmoh::accessors::is_attribute_accessor<Accessors>...
+        >(index, function);
+    }
+
+    /**
+     * Get the value of the attribute with a specific index
+     *
+     * The `visitor` is called with the value of the attribute with the index
+     * `index`. The attribute's accessor is reached via a table generated at
+     * compile time.
+     *
+     * \returns true if the visitor was called, false if there is no
+     *          attribute with the index supplied
+     */
+    template <
+        typename Visitor ///< type of the visitor
+    >
+    bool
+    get_at(
+        object_type const& obj, ///< object from which to get the value
+        std::size_t index, ///< index of the attribute
+        Visitor&& visitor ///< visitor receiving the value
+    ) const {
+        return visit_attribute_at(index, [&] (auto const& accessor) {
+            visitor(accessor.get(obj));
+        });
+    }
+
+    /**
+     * Get the value of the attribute with a specific index
+     *
+     * Like the dynamic `get()`, but the attribute is identified by its index
+     * and reached via a table generated at compile time.
+     *
+     * \returns an optional holding the value or an empty optional, if there is
+     *          no attribute with the index supplied or its type is not
+     *          convertible to `Type`
+     */
+    template <
+        typename Type ///< type of the attribute to get
+    >
+    optional<Type>
+    get_at(
+        object_type const& obj, ///< object from which to get the value
+        std::size_t index ///< index of the attribute
+    ) const {
+        optional<Type> retval;
+        visit_attribute_at(index, [&] (auto const& accessor) {
+            get_if<Type>(accessor, obj, retval, is_readable_as<
+                typename std::decay<decltype(accessor)>::type,
+                Type
+            >());
+        });
+        return retval;
+    }
+
+    /**
+     * Set the value of the attribute with a specific index
+     *
+     * Like the dynamic `set()`, but the attribute is identified by its index
+     * and reached via a table generated at compile time.
+     *
+     * \returns true if the value was set, false if there is no attribute with
+     *          the index supplied, it is not settable or its type is not
+     *          convertible to `Type`
+     */
+    template <
+        typename Type ///< type of the attribute to set
+    >
+    bool
+    set_at(
+        object_type& obj, ///< object on which to set the attribute
+        std::size_t index, ///< index of the attribute
+        Type&& value ///< value to set
+    ) const {
+        bool retval = false;
+        visit_attribute_at(index, [&] (auto const& accessor) {
+            typedef typename std::decay<decltype(accessor)>::type accessor_type;
+            retval = set_if(
+                accessor,
+                obj,
+                std::forward<Type>(value),
+                std::integral_constant<
+                    bool,
+                    cmoh::accessors::is_settable<accessor_type>::value &&
+                    is_readable_as<accessor_type, Type>::value
+                >()
+            );
+            if (retval)
+                invalidate_dependents(obj, cmoh::accessors::key(accessor));
+        });
+        return retval;
+    }
+
+
+    accessor_bundle(Accessors... accessors) :
+            _accessors(std::forward<Accessors>(accessors)...) {}
+    accessor_bundle(accessor_bundle const&) = default;
+    accessor_bundle(accessor_bundle&&) = default;
+    accessor_bundle() = delete;
+
+
+    /**
+     * Set the value of a specific attribute on an object
+     */
+    template <
+        key_type ...keys ///< keys of attributes from which to construct an object
+    >
+    object_type
+    create(
+        typename property_by_key<keys>::type&&... values ///< values to use
+    ) const {
+        auto factory = select_factory<keys...>();
+
+        // construct the object itself
+        auto retval{factory.template create<property_by_key<keys>...>(
+            std::forward<typename property_by_key<keys>::type>(values)...
+        )};
+
+        initialize_if_unused<decltype(factory), keys...>(
+            retval,
+            std::forward<typename property_by_key<keys>::type>(values)...
+        );
+
+        return retval;
+    }
+
+    /**
+     * Create an object in the storage supplied
+     *
+     * The object is constructed in place by the factory selected and the
+     * remaining attributes are set on it directly, without any temporary
+     * object or move. If setting an attribute throws, the object is destroyed
+     * before the exception is propagated.
+     *
+     * The storage must be suitably sized and aligned for an `object_type`.
+     * The caller is responsible for destroying the object.
+     *
+     * \returns a pointer to the object created
+     */
+    template <
+        key_type ...keys ///< keys of attributes from which to construct an object
+    >
+    object_type*
+    create_at(
+        void* storage, ///< storage in which to construct the object
+        typename property_by_key<keys>::type&&... values ///< values to use
+    ) const {
+        auto factory = select_factory<keys...>();
+
+        auto retval = factory.template create_at<property_by_key<keys>...>(
+            storage,
+            std::forward<typename property_by_key<keys>::type>(values)...
+        );
+
+        // destroy the object if a setter throws
+        struct guard {
+            ~guard() {
+                if (obj)
+                    obj->~object_type();
+            }
+            object_type* obj;
+        } destroy_on_failure{retval};
+
+        initialize_if_unused<decltype(factory), keys...>(
+            *retval,
+            std::forward<typename property_by_key<keys>::type>(values)...
+        );
+
+        destroy_on_failure.obj = nullptr;
+        return retval;
+    }
+
+    /**
+     * Create an object at the end of a container
+     *
+     * The object is constructed in place via the container's `emplace_back()`
+     * using the constructor of the factory selected, and the remaining
+     * attributes are set on the new element directly. If setting an attribute
+     * throws, the element is removed via `pop_back()`.
+     *
+     * Since the object is constructed via `emplace_back()`, the factory's
+     * constructor is invoked using parentheses rather than braces.
+     *
+     * \returns a reference to the element created
+     */
+    template <
+        key_type ...keys, ///< keys of attributes from which to construct an object
+        typename Container ///< type of the container
+    >
+    typename Container::reference
+    emplace_into(
+        Container& container, ///< container to which to append the object
+        typename property_by_key<keys>::type&&... values ///< values to use
+    ) const {
+        auto factory = select_factory<keys...>();
+
+        factory.template emplace_into<property_by_key<keys>...>(
+            container,
+            std::forward<typename property_by_key<keys>::type>(values)...
+        );
+
+        // remove the element if a setter throws
+        struct guard {
+            ~guard() {
+                if (target)
+                    target->pop_back();
+            }
+            Container* target;
+        } remove_on_failure{&container};
+
+        initialize_if_unused<decltype(factory), keys...>(
+            container.back(),
+            std::forward<typename property_by_key<keys>::type>(values)...
+        );
+
+        remove_on_failure.target = nullptr;
+        return container.back();
+    }
+
+    /**
+     * Create a batch of objects from columns of values
+     *
+     * This method appends `count` objects to the `container` supplied. The
+     * values of the n-th object are taken from the n-th element of each of the
+     * `columns`, which are iterators and correspond to the `keys`. Values are
+     * moved out of the columns. If the container provides a method
+     * `reserve()`, the capacity for all objects is reserved up front.
+     *
+     * Objects are created via `emplace_into()`. The factory is selected once,
+     * at compile time, hence no dispatch takes place per object. If the
+     * objects are trivially default constructible and destructible and the
+     * container provides a method `resize()`, the container is resized once
+     * and the objects are created in place via `create_at()` instead.
+     *
+     * If creating an object throws, all objects appended by the call are
+     * removed via `pop_back()` before the exception is propagated.
+     */
+    template <
+        key_type ...keys, ///< keys of attributes from which to construct objects
+        typename Container, ///< type of the container
+        typename ...Iterators ///< types of the columns
+    >
+    void
+    create_batch(
+        Container& container, ///< container to which to append the objects
+        std::size_t count, ///< number of objects to create
+        Iterators... columns ///< iterators to the first values of each column
+    ) const {
+        static_assert(
+            sizeof...(keys) == sizeof...(Iterators),
+            "Number of columns does not match number of keys"
+        );
+
+        // remove the objects appended if one of them can not be created
+        struct guard {
+            ~guard() {
+                if (target)
+                    while (target->size() > size)
+                        target->pop_back();
+            }
+            Container* target;
+            std::size_t size;
+        } truncate_on_failure{&container, container.size()};
+
+        append_batch<keys...>(container, count, 0, columns...);
+
+        truncate_on_failure.target = nullptr;
+    }
+
+
+    /**
+     * Create an object in an arena
+     *
+     * The object is constructed in memory allocated from the `arena` supplied
+     * and adopted by the arena, which destroys it on release. Values of
+     * attributes whose types are allocator-aware and accept the arena's
+     * allocator are rebuilt using that allocator before being passed on.
+     *
+     * The arena has to provide the members `allocate()`, `reserve_adoption()`,
+     * `adopt()` and `get_allocator()` of `cmoh::arena`, defined in
+     * `<cmoh/arena.hpp>`.
+     *
+     * \returns a pointer to the object created, owned by the arena
+     */
+    template <
+        key_type ...keys, ///< keys of attributes from which to construct an object
+        typename Arena ///< type of the arena
+    >
+    object_type*
+    create_in(
+        Arena& arena, ///< arena in which to create the object
+        typename property_by_key<keys>::type&&... values ///< values to use
+    ) const {
+        // the adoption must not fail once the object is constructed
+        arena.template reserve_adoption<object_type>();
+        auto const allocator = arena.get_allocator();
+        return arena.adopt(create_at<keys...>(
+            arena.allocate(sizeof(object_type), alignof(object_type)),
+            with_allocator(
+                allocator,
+                std::forward<typename property_by_key<keys>::type>(values)
+            )...
+        ));
+    }
+
+
+    /**
+     * Get the value of a specific attribute from an object
+     *
+     * \returns the value of the attribute
+     */
+    template <
+        key_type key ///< key of attribute to get
+    >
+    typename property_by_key<key>::type
+    get(
+        object_type const& obj ///< object from which to get the value
+    ) const {
+        return _accessors.template get<
+            cmoh::accessors::accesses<Accessors, key_type, key>...
+        >().get(obj);
+    }
+
+    /**
+     * Set the value of a specific attribute on an object
+     */
+    template <
+        key_type key ///< key of attribute to set
+    >
+    void
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        typename property_by_key<key>::type&& value ///< value to set
+    ) const {
+        _accessors.template get<
+            cmoh::accessors::accesses<Accessors, key_type, key>...
+        >().set(obj, std::forward<typename property_by_key<key>::type>(value));
+        invalidate_dependents<key>(obj);
+    }
+
+
+    /**
+     * Get the value of a specific attribute from an object
+     *
+     * \returns the value of the attribute
+     */
+    template <
+        typename Type, ///< type of the attribute to get
+        typename KeyType = key_type ///< key type to use
+    >
+    optional<Type>
+    get(
+        object_type const& obj, ///< object from which to get the value
+        KeyType&& key ///< key of the attribute to get
+    ) const {
+        optional<Type> retval;
+
+        visit_attributes_until<Type>([&] (auto const& accessor) {
+            if (!(cmoh::accessors::key(accessor) == key))
+                return false;
+            retval = accessor.get(obj);
+            return true;
+        });
+
+        return retval;
+    }
+
+    /**
+     * Set the value of a specific attribute on an object
+     */
+    template <
+        typename Type, ///< type of the attribute to get
+        typename KeyType = key_type ///< key type to use
+    >
+    bool
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        KeyType&& key, ///< key of the attribute to get
+        Type&& value ///< value to set
+    ) const {
+        std::size_t index;
+        return set<Type>(
+            obj,
+            std::forward<KeyType>(key),
+            std::forward<Type>(value),
+            index
+        );
+    }
+
+    /**
+     * Set the value of a specific attribute on an object
+     *
+     * Like the other dynamic `set()`, but on success, `index` is assigned the
+     * `settable_index()` of the attribute which was set.
+     */
+    template <
+        typename Type, ///< type of the attribute to get
+        typename KeyType = key_type ///< key type to use
+    >
+    bool
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        KeyType&& key, ///< key of the attribute to get
+        Type&& value, ///< value to set
+        std::size_t& index ///< settable index of the attribute set
+    ) const {
+        bool const retval = visit_settable_attributes_until<Type>(
+            [&] (auto const& accessor) {
+                if (!(cmoh::accessors::key(accessor) == key))
+                    return false;
+                accessor.set(obj, std::forward<Type>(value));
+                index = settable_index_of<
+                    typename std::decay<decltype(accessor)>::type
+                >();
+                return true;
+            }
+        );
+
+        if (retval)
+            invalidate_dependents(obj, key);
+        return retval;
+    }
+
+
+    /**
+     * Invoke a specific method on an object
+     *
+     * The arguments are passed on to the method's accessor, which converts
+     * them to the types of the method's parameters.
+     *
+     * \returns the value returned by the method
+     */
+    template <
+        key_type key, ///< key of the method to invoke
+        typename ...Args ///< types of the arguments
+    >
+    typename property_by_key<key>::result_type
+    invoke(
+        object_type& obj, ///< object on which to invoke the method
+        Args&&... args ///< arguments passed to the method
+    ) const {
+        return _accessors.template get<
+            cmoh::accessors::accesses<Accessors, key_type, key>...
+        >().invoke(obj, std::forward<Args>(args)...);
+    }
+
+
+    /**
+     * Compute a patch transforming one object into another
+     *
+     * The patch will contain the values of all settable attributes of `to`
+     * which differ from those of `from`. Attributes are compared using
+     * `operator ==`.
+     *
+     * The header `<cmoh/patch.hpp>` has to be included for using this method.
+     *
+     * \returns a patch containing the changed attributes
+     */
+    template <
+        typename Patch = patch ///< type of the patch to produce
+    >
+    Patch
+    diff(
+        object_type const& from, ///< original object
+        object_type const& to ///< object to which the patch should lead
+    ) const {
+        Patch retval;
+        std::size_t index = 0;
+
+        visit_settable_attributes([&] (auto const& accessor) {
+            auto value = accessor.get(to);
+            if (!(accessor.get(from) == value))
+                retval.add(index, value);
+            ++index;
+        });
+
+        return retval;
+    }
+
+    /**
+     * Apply a patch to an object
+     *
+     * The values contained in the patch are set using the attributes' setters,
+     * in the order of the accessors. Each entry's accessor is reached directly
+     * via its index, so the cost does not depend on the number of attributes
+     * not contained in the patch. If the patch turns out to be malformed, the
+     * application stops. In this case, the object may be left with only some
+     * of the attributes set.
+     *
+     * The header `<cmoh/patch.hpp>` has to be included for using this method.
+     *
+     * \returns true if the patch was applied completely, false otherwise
+     */
+    template <
+        typename Patch ///< type of the patch to apply
+    >
+    bool
+    apply(
+        object_type& obj, ///< object to which to apply the patch
+        Patch const& p ///< patch to apply
+    ) const {
+        typename Patch::reader reader(p);
+        std::size_t index;
+        std::size_t minimum = 0; // entries appear in ascending order
+
+        while (reader.entry(index)) {
+            bool applied = false;
+            if (index < minimum)
+                return false;
+
+            visit_settable_attribute_at(index, [&] (auto const& accessor) {
+                typedef typename attribute_of<decltype(accessor)>::type type;
+                type value;
+                if ((applied = reader.read(value))) {
+                    accessor.set(obj, std::move(value));
+                    invalidate_dependents(obj, cmoh::accessors::key(accessor));
+                }
+            });
+            if (!applied)
+                return false;
+            minimum = index + 1;
+        }
+
+        return reader.done();
+    }
+
+
+    /**
+     * Sort a sequence of objects by the value of a specific attribute
+     *
+     * The value of the attribute is retrieved exactly once per object. The
+     * objects are then ordered by a permutation computed from those values,
+     * which is finally applied to the sequence in place. Like
+     * `std::stable_sort()`, the relative order of objects with equal values is
+     * preserved. Large sequences are sorted by multiple threads, which may
+     * retrieve values concurrently.
+     *
+     * The header `<cmoh/sort.hpp>` has to be included for using this method.
+     */
+    template <
+        key_type key, ///< key of the attribute by which to sort
+        typename RandomIt ///< type of the iterators
+    >
+    void
+    sort_by(
+        RandomIt first, ///< start of the sequence to sort
+        RandomIt last ///< end of the sequence to sort
+    ) const {
+        auto const& accessor = _accessors.template get<
+            cmoh::accessors::accesses<Accessors, key_type, key>...
+        >();
+
+        sort::sorter<typename property_by_key<key>::type, void>::sort(
+            first,
+            last,
+            [&] (std::size_t index) { return accessor.get(first[index]); }
+        );
+    }
+
+    /**
+     * Sort a range of objects by the value of a specific attribute
+     */
+    template <
+        key_type key, ///< key of the attribute by which to sort
+        typename Range ///< type of the range
+    >
+    void
+    sort_by(
+        Range& range ///< range to sort
+    ) const {
+        using std::begin;
+        using std::end;
+        sort_by<key>(begin(range), end(range));
+    }
+
+
+    /**
+     * Compute a hash of an object from its attributes
+     *
+     * The hash is computed from the values of all attributes accessible via
+     * this bundle. Hence, objects considered equal by `equal()` will yield
+     * the same hash.
+     *
+     * The header `<cmoh/hash.hpp>` has to be included for using this method.
+     *
+     * \returns the hash of the object
+     */
+    std::size_t
+    hash(
+        object_type const& obj ///< object to hash
+    ) const {
+        std::uint64_t retval = 0;
+
+        auto combine = [&] (auto const& accessor) {
+            typedef typename attribute_of<decltype(accessor)>::type type;
+            retval = hashing::hasher<type, void>::combine(
+                retval,
+                accessor.get(obj)
+            );
+        };
+        _accessors.template visit<
+            decltype(combine)&,
+            std::integral_constant<
+                bool,
+                !std::is_void<typename attribute_of<Accessors>::type>::value
+            >...
+        >(combine);
+
+        return static_cast<std::size_t>(retval);
+    }
+
+    /**
+     * Check whether two objects are equal with regard to their attributes
+     *
+     * The objects are considered equal if the values of all attributes
+     * accessible via this bundle compare equal. Attributes of trivially
+     * copyable types are compared first. The comparison stops at the first
+     * attribute found to differ.
+     *
+     * \returns true if the objects are equal, false otherwise
+     */
+    bool
+    equal(
+        object_type const& lhs, ///< first object to compare
+        object_type const& rhs ///< second object to compare
+    ) const {
+        return !visit_attributes_by_cost_until([&] (auto const& accessor) {
+            return !(accessor.get(lhs) == accessor.get(rhs));
+        });
+    }
+
+    /**
+     * Compare two objects with regard to their attributes
+     *
+     * Objects are ordered lexicographically by the values of the attributes
+     * accessible via this bundle, using `operator <`. Attributes of trivially
+     * copyable types are compared first, in the order of the accessors. All
+     * other attributes follow, again in the order of the accessors.
+     *
+     * \returns a negative value if `lhs` is ordered before `rhs`, a positive
+     *          value if `lhs` is ordered after `rhs` and zero otherwise
+     */
+    int
+    compare(
+        object_type const& lhs, ///< first object to compare
+        object_type const& rhs ///< second object to compare
+    ) const {
+        int retval = 0;
+
+        visit_attributes_by_cost_until([&] (auto const& accessor) {
+            auto const lhs_value = accessor.get(lhs);
+            auto const rhs_value = accessor.get(rhs);
+            if (lhs_value < rhs_value)
+                retval = -1;
+            else if (rhs_value < lhs_value)
+                retval = 1;
+            return retval != 0;
+        });
+
+        return retval;
+    }
+
+
+    /**
+     * Calls a function with every accessor accessing a property
+     *
+     * This method applies the function supplied on every accessor which
+     * accesses a single property. The function will be calles with the
+     * accessors as the only argument.
+     */
+    template <
+        typename Function
+    >
+    void
+    visit_properties(
+        Function&& function
+    ) const {
+        _accessors.template visit<
+            Function,
+            std::integral_constant<
+                bool,
+                !std::is_same<
+                    typename cmoh::accessors::property<Accessors>::type,
+                    void
+                >::value
+            >...
+        >(std::forward<Function>(function));
+    }
+
+
+    /**
+     * Calls a function with accessors accessing a property until it returns true
+     *
+     * Like `visit_properties()`, but the traversal stops as soon as the
+     * function returns `true`.
+     *
+     * \returns true if the traversal was stopped by the function
+     */
+    template <
+        typename Function
+    >
+    bool
+    visit_properties_until(
+        Function&& function
+    ) const {
+        return _accessors.template visit_until<
+            Function,
+            std::integral_constant<
+                bool,
+                !std::is_same<
+                    typename cmoh::accessors::property<Accessors>::type,
+                    void
+                >::value
+            >...
+        >(std::forward<Function>(function));
+    }
+
+
+    /**
+     * Calls a function with every accessor accessing a settable attribute
+     *
+     * This method applies the function supplied on every accessor which
+     * accesses a settable attribute, in the order of the accessors. Hence, the
+     * n-th accessor visited is the one with the settable index n.
+     */
+    template <
+        typename Function
+    >
+    void
+    visit_settable_attributes(
+        Function&& function
+    ) const {
+        _accessors.template visit<
+            Function,
+            cmoh::accessors::is_settable<Accessors>...
+        >(std::forward<Function>(function));
+    }
+
+    /**
+     * Calls a function with settable attributes' accessors until it returns
+     * true
+     *
+     * Like `visit_settable_attributes()`, but the traversal stops as soon as
+     * the function returns `true`.
+     *
+     * \returns true if the traversal was stopped by the function
+     */
+    template <
+        typename Function
+    >
+    bool
+    visit_settable_attributes_until(
+        Function&& function
+    ) const {
+        return _accessors.template visit_until<
+            Function,
+            cmoh::accessors::is_settable<Accessors>...
+        >(std::forward<Function>(function));
+    }
+
+    /**
+     * Calls a function with the accessor of the settable attribute at an index
+     *
+     * The accessor is reached via a table generated at compile time rather
+     * than by visiting the accessors preceding it.
+     *
+     * \returns true if the function was called, false if there is no settable
+     *          attribute with the index supplied
+     */
+    template <
+        typename Function
+    >
+    bool
+    visit_settable_attribute_at(
+        std::size_t index, ///< settable index of the attribute
+        Function&& function
+    ) const {
+        return _accessors.template visit_at<
+            Function&,
+            cmoh::accessors::is_settable<Accessors>...
+        >(index, function);
+    }
+
+
+    /**
+     * Calls a function with every method accessor
+     *
+     * This method applies the function supplied on every accessor which
+     * accesses a method, in the order of the accessors. Hence, the n-th
+     * accessor visited is the one with the method index n.
+     */
+    template <
+        typename Function
+    >
+    void
+    visit_methods(
+        Function&& function
+    ) const {
+        _accessors.template visit<
+            Function,
+            cmoh::accessors::is_method_accessor<Accessors>...
+        >(std::forward<Function>(function));
+    }
+
+
+    /**
+     * Check whether any accessor caches values which may have to be invalidated
+     *
+     * Provides the member `value`, which is true if the bundle contains an
+     * accessor caching values, e.g. a memoizing accessor.
+     */
+    typedef std::integral_constant<
+        bool,
+        util::disjunction<cmoh::accessors::is_invalidatable<Accessors>...>::value
+    > has_dependents;
+
+    /**
+     * Invalidate values cached for an object which depend on an attribute
+     *
+     * Setting attributes via the bundle invalidates dependent values already.
+     * This method is meant for code setting attributes by other means, e.g.
+     * via accessors directly.
+     */
+    template <
+        typename KeyType = key_type ///< key type to use
+    >
+    void
+    invalidate(
+        object_type const& obj, ///< object modified
+        KeyType const& key ///< key of the attribute modified
+    ) const {
+        invalidate_dependents(obj, key);
+    }
+
+
+private:
+    /**
+     * Get the factory used for creating an object from specific attributes
+     */
+    template <
+        key_type ...keys ///< keys of the attributes supplied
+    >
+    factory_for<keys...> const&
+    select_factory() const noexcept {
+        return factory_selector<
+            std::make_index_sequence<sizeof...(Accessors)>,
+            keys...
+        >::get(_accessors);
+    }
+
+
+    /**
+     * Append a batch of objects to a container
+     *
+     * This overload is used for objects which are trivially default
+     * constructible and destructible if the container provides a method
+     * `resize()`. The container is resized once and each object is created
+     * over the default constructed element.
+     */
+    template <
+        key_type ...keys,
+        typename Container,
+        typename ...Iterators
+    >
+    auto
+    append_batch(
+        Container& container,
+        std::size_t count,
+        int,
+        Iterators... columns
+    ) const -> typename std::enable_if<
+        std::is_trivially_default_constructible<object_type>::value &&
+        std::is_trivially_destructible<object_type>::value,
+        decltype(container.resize(count))
+    >::type {
+        auto const first = container.size();
+        container.resize(first + count);
+
+        auto pos = std::next(
+            container.begin(),
+            static_cast<typename Container::difference_type>(first)
+        );
+        for (std::size_t i = 0; i < count; ++i, ++pos) {
+            create_at<keys...>(std::addressof(*pos), std::move(*columns)...);
+            (void) std::initializer_list<int>{(++columns, 0)...};
+        }
+    }
+
+    // overload appending objects one by one via `emplace_into()`
+    template <
+        key_type ...keys,
+        typename Container,
+        typename ...Iterators
+    >
+    void
+    append_batch(
+        Container& container,
+        std::size_t count,
+        long,
+        Iterators... columns
+    ) const {
+        reserve(container, container.size() + count, 0);
+        for (std::size_t i = 0; i < count; ++i) {
+            emplace_into<keys...>(container, std::move(*columns)...);
+            (void) std::initializer_list<int>{(++columns, 0)...};
+        }
+    }
+
+
+    /**
+     * Reserve capacity in a container, if supported
+     */
+    template <
+        typename Container
+    >
+    static
+    auto
+    reserve(
+        Container& container,
+        std::size_t capacity,
+        int
+    ) -> decltype(container.reserve(capacity)) {
+        return container.reserve(capacity);
+    }
+
+    // overload for containers without a method `reserve()`
+    template <
+        typename Container
+    >
+    static
+    void
+    reserve(
+        Container&,
+        std::size_t,
+        long
+    ) {}
+
+
+    /**
+     * Check whether a type uses an allocator constructible from `Allocator`
+     */
+    template <
+        typename Value, ///< type to check
+        typename Allocator, ///< type of the allocator
+        typename = void
+    >
+    struct accepts_allocator : std::false_type {};
+
+    template <
+        typename Value,
+        typename Allocator
+    >
+    struct accepts_allocator<
+        Value,
+        Allocator,
+        util::void_t<typename Value::allocator_type>
+    > : std::is_constructible<
+        typename Value::allocator_type,
+        Allocator const&
+    > {};
+
+
+    /**
+     * Rebuild a value using an allocator, if its type is allocator-aware
+     *
+     * If the value's type has a member type `allocator_type` constructible
+     * from the `allocator` supplied, a copy of the value using that allocator
+     * is returned. Otherwise, the value is passed through.
+     */
+    template <
+        typename Allocator, ///< type of the allocator to use
+        typename Value ///< type of the value
+    >
+    static
+    typename std::enable_if<
+        accepts_allocator<Value, Allocator>::value,
+        typename std::remove_cv<Value>::type
+    >::type
+    with_allocator(
+        Allocator const& allocator, ///< allocator to use
+        Value&& value ///< value to rebuild
+    ) {
+        return typename std::remove_cv<Value>::type(
+            std::move(value),
+            typename Value::allocator_type(allocator)
+        );
+    }
+
+    // overload for values not using a compatible allocator
+    template <
+        typename Allocator,
+        typename Value
+    >
+    static
+    typename std::enable_if<
+        !accepts_allocator<Value, Allocator>::value,
+        Value&&
+    >::type
+    with_allocator(
+        Allocator const&,
+        Value&& value
+    ) {
+        return std::forward<Value>(value);
+    }
+
+
+    /**
+     * Initialize attributes which are not used by a specific constructor
+     */
+    template <
+        typename Constructor, ///< constructor to consider
+        key_type key0, ///< first of the attributes' keys
+        key_type ...keys ///< rest of the attributes' keys
+    >
+    void
+    initialize_if_unused(
+        object_type& obj, ///< object on which to set the attributes' values
+        typename property_by_key<key0>::type&& value0, ///< first of the values
+        typename property_by_key<keys>::type&&... values ///< rest of the values
+    ) const {
+        initialize_single_if_unused<Constructor, key0>(
+            obj,
+            std::forward<typename property_by_key<key0>::type>(value0)
+        );
+
+        // recurse
+        initialize_if_unused<Constructor, keys...>(
+            obj,
+            std::forward<typename property_by_key<keys>::type>(values)...
+        );
+    }
+
+    // overload for an empty list of attributes
+    template <
+        typename Constructor
+    >
+    void
+    initialize_if_unused(
+        object_type& obj
+    ) const {}
+
+
+    /**
+     * Initialize a single attribute if it is not used by a specific constructor
+     */
+    template <
+        typename Constructor, ///< constructor to consider
+        key_type key ///< attribute to set
+    >
+    typename std::enable_if<
+        !Constructor::template uses<key>::value
+    >::type
+    initialize_single_if_unused(
+        object_type& obj, ///< object on which to set the attribute's value
+        typename property_by_key<key>::type&& value ///< value to set
+    ) const {
+        // TODO: static assertion for unsettable attributes
+        set<key>(obj, std::forward<typename property_by_key<key>::type>(value));
+    }
+
+    // overload for attributes which are used by the constructor specified
+    template <
+        typename Constructor,
+        key_type key
+    >
+    typename std::enable_if<
+        Constructor::template uses<key>::value
+    >::type
+    initialize_single_if_unused(
+        object_type& obj,
+        typename property_by_key<key>::type&& value
+    ) const {}
+
+
+    /**
+     * Invalidate cached values depending on a specific attribute
+     *
+     * This method invalidates the values cached for an object by all
+     * accessors which declare a dependency on the attribute identified by
+     * `key`, e.g. memoizing accessors. For bundles without such accessors,
+     * the method does nothing and the dependencies are never instantiated.
+     */
+    template <
+        key_type key ///< key of the attribute modified
+    >
+    void
+    invalidate_dependents(
+        object_type const& obj ///< object modified
+    ) const {
+        invalidate_dependents<key>(obj, has_dependents());
+    }
+
+    template <
+        key_type key
+    >
+    void
+    invalidate_dependents(
+        object_type const& obj,
+        std::true_type
+    ) const {
+        auto invalidate = [&obj] (auto const& accessor) {
+            accessor.invalidate(obj);
+        };
+        _accessors.template visit<
+            decltype(invalidate)&,
+            cmoh::accessors::depends_on<Accessors, key_type, key>...
+        >(invalidate);
+    }
+
+    template <
+        key_type key
+    >
+    void
+    invalidate_dependents(
+        object_type const&,
+        std::false_type
+    ) const {}
+
+    // overload for keys supplied at run time
+    template <
+        typename KeyType ///< key type to use
+    >
+    void
+    invalidate_dependents(
+        object_type const& obj, ///< object modified
+        KeyType const& key ///< key of the attribute modified
+    ) const {
+        invalidate_dependents(obj, key, has_dependents());
+    }
+
+    template <
+        typename KeyType
+    >
+    void
+    invalidate_dependents(
+        object_type const& obj,
+        KeyType const& key,
+        std::true_type
+    ) const {
+        auto invalidate = [&] (auto const& accessor) {
+            if (accessor.depends_on_key(key))
+                accessor.invalidate(obj);
+        };
+        _accessors.template visit<
+            decltype(invalidate)&,
+            cmoh::accessors::is_invalidatable<Accessors>...
+        >(invalidate);
+    }
+
+    template <
+        typename KeyType
+    >
+    void
+    invalidate_dependents(
+        object_type const&,
+        KeyType const&,
+        std::false_type
+    ) const {}
+
+
+    /**
+     * Attribute accessed by an accessor
+     *
+     * Exports the attribute accessed by an accessor, which may be a reference
+     * type, via the member `type`.
+     */
+    template <
+        typename Accessor
+    >
+    using attribute_of = properties::type_of_attribute<
+        typename cmoh::accessors::property<
+            typename std::decay<Accessor>::type
+        >::type
+    >;
+
+
+    /**
+     * Call a function with attribute accessors, cheap ones first, until it
+     * returns true
+     *
+     * The function is first called with the accessors for attributes of
+     * trivially copyable types, then with all other attribute accessors.
+     *
+     * \returns true if the traversal was stopped by the function
+     */
+    template <
+        typename Function
+    >
+    bool
+    visit_attributes_by_cost_until(
+        Function&& function
+    ) const {
+        return _accessors.template visit_until<
+            Function&,
+            std::integral_constant<
+                bool,
+                !std::is_void<typename attribute_of<Accessors>::type>::value &&
+                std::is_trivially_copyable<
+                    typename attribute_of<Accessors>::type
+                >::value
+            >...
+        >(function) || _accessors.template visit_until<
+            Function&,
+            std::integral_constant<
+                bool,
+                !std::is_void<typename attribute_of<Accessors>::type>::value &&
+                !std::is_trivially_copyable<
+                    typename attribute_of<Accessors>::type
+                >::value
+            >...
+        >(function);
+    }
+
+
+    /**
+     * Check whether the value of an attribute is convertible to a type
+     */
+    template <
+        typename Accessor,
+        typename Type
+    >
+    using is_readable_as = std::is_convertible<
+        typename properties::type_of_attribute<
+            typename cmoh::accessors::property<Accessor>::type
+        >::type,
+        Type
+    >;
+
+    template <
+        typename Type,
+        typename Accessor
+    >
+    static
+    void
+    get_if(
+        Accessor const& accessor,
+        object_type const& obj,
+        optional<Type>& retval,
+        std::true_type
+    ) {
+        retval = accessor.get(obj);
+    }
+
+    // overload for attributes not convertible to `Type`
+    template <
+        typename Type,
+        typename Accessor
+    >
+    static
+    void
+    get_if(
+        Accessor const&,
+        object_type const&,
+        optional<Type>&,
+        std::false_type
+    ) {}
+
+    template <
+        typename Accessor,
+        typename Type
+    >
+    static
+    bool
+    set_if(
+        Accessor const& accessor,
+        object_type& obj,
+        Type&& value,
+        std::true_type
+    ) {
+        accessor.set(obj, std::forward<Type>(value));
+        return true;
+    }
+
+    // overload for attributes which are not settable or convertible
+    template <
+        typename Accessor,
+        typename Type
+    >
+    static
+    bool
+    set_if(
+        Accessor const&,
+        object_type&,
+        Type&&,
+        std::false_type
+    ) {
+        return false;
+    }
+
+    template <
+        typename Type,
+        typename Function
+    >
+    bool
+    visit_attributes_until(
+        Function&& function
+    ) const {
+        return _accessors.template visit_until<
+            Function,
+            std::is_convertible<
+                typename properties::type_of_attribute<
+                    typename cmoh::accessors::property<Accessors>::type
+                >::type,
+                Type
+            >...
+        >(std::forward<Function>(function));
+    }
+
+    /**
+     * Get the settable index of the attribute accessed by a specific accessor
+     */
+    template <
+        typename Accessor
+    >
+    static
+    constexpr
+    std::size_t
+    settable_index_of() noexcept {
+        constexpr bool settable[] = {
+            cmoh::accessors::is_settable<Accessors>::value...
+        };
+        constexpr bool matches[] = {
+            std::is_same<Accessors, Accessor>::value...
+        };
+
+        std::size_t retval = 0;
+        for (std::size_t i = 0; !(settable[i] && matches[i]); ++i)
+            if (settable[i])
+                ++retval;
+        return retval;
+    }
+
+    template <
+        typename Type,
+        typename Function
+    >
+    bool
+    visit_settable_attributes_until(
+        Function&& function
+    ) const {
+        return _accessors.template visit_until<
+            Function,
+            std::integral_constant<
+                bool,
+                cmoh::accessors::is_settable<Accessors>::value &&
+                std::is_convertible<
+                    typename properties::type_of_attribute<
+                        typename cmoh::accessors::property<Accessors>::type
+                    >::type,
+                    Type
+                >::value
+            >...
+        >(std::forward<Function>(function));
+    }
+
+
+
+    /**
+     * Hash table mapping attributes' keys to their indices
+     *
+     * The table uses open addressing with linear probing. Its size is a power
+     * of two of at least twice the number of attributes. Keys other than
+     * integers and enums, e.g. string views, are hashed by their contents and
+     * must provide `data()` and `size()`.
+     */
+    struct index_table {
+        typedef typename std::decay<key_type>::type value_type;
+
+        index_table(accessor_bundle const& bundle) : slots() {
+            std::size_t index = 0;
+            bundle.visit_properties([&] (auto const& accessor) {
+                if (!cmoh::accessors::is_attribute_accessor<
+                    typename std::decay<decltype(accessor)>::type
+                >::value)
+                    return;
+
+                keys[index] = cmoh::accessors::key(accessor);
+                auto slot = hash(keys[index]);
+                while (slots[slot & (size - 1)] != 0)
+                    ++slot;
+                slots[slot & (size - 1)] = ++index;
+            });
+        }
+
+        template <
+            typename KeyType
+        >
+        std::size_t
+        find(
+            KeyType const& key
+        ) const {
+            value_type const value(key);
+            for (auto slot = hash(value); ; ++slot) {
+                auto const entry = slots[slot & (size - 1)];
+                if (entry == 0)
+                    return npos;
+                if (keys[entry - 1] == value)
+                    return entry - 1;
+            }
+        }
+
+    private:
+        static
+        constexpr
+        std::size_t
+        size_for(
+            std::size_t count
+        ) {
+            std::size_t retval = 1;
+            while (retval < 2*count)
+                retval *= 2;
+            return retval;
+        }
+
+        static
+        std::size_t
+        hash(
+            value_type const& key
+        ) {
+            return hash(key, std::integral_constant<
+                bool,
+                std::is_integral<value_type>::value ||
+                std::is_enum<value_type>::value
+            >());
+        }
+
+        // integers and enums are spread via a multiplication with an odd
+        // constant (a bijection modulo the table's size)
+        static
+        std::size_t
+        hash(
+            value_type const& key,
+            std::true_type
+        ) {
+            return static_cast<std::size_t>(key) * 0x9e3779b9u;
+        }
+
+        // other keys, e.g. string views, are hashed by their contents using
+        // FNV-1a
+        static
+        std::size_t
+        hash(
+            value_type const& key,
+            std::false_type
+        ) {
+            std::size_t retval = 2166136261u;
+            auto const data = key.data();
+            for (std::size_t i = 0; i < key.size(); ++i) {
+                retval ^= static_cast<unsigned char>(data[i]);
+                retval *= 16777619u;
+            }
+            return retval;
+        }
+
+        static constexpr std::size_t size = size_for(attribute_count);
+
+        // index of the attribute plus one, zero for empty slots
+        std::array<std::size_t, size> slots;
+
+        // keys of the attributes, by index
+        std::array<value_type, attribute_count> keys;
+    };
+
+    accessors _accessors;
+};
+
+
+// definition of the static member, required if it is odr-used
+template <
+    typename ...Accessors
+>
+constexpr std::size_t accessor_bundle<Accessors...>::settable_count;
+
+template <
+    typename ...Accessors
+>
+constexpr std::size_t accessor_bundle<Accessors...>::method_count;
+
+template <
+    typename ...Accessors
+>
+constexpr std::size_t accessor_bundle<Accessors...>::attribute_count;
+
+template <
+    typename ...Accessors
+>
+constexpr std::size_t accessor_bundle<Accessors...>::npos;
 
 
 /**
@@ -0,0 +1,372 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_ATTRIBUTE_BY_BITS_HPP__
+#define CMOH_ATTRIBUTE_BY_BITS_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+
+// local includes
+#include <cmoh/byte_order.hpp>
+
+
+namespace cmoh {
+namespace util {
+
+
+/**
+ * Integral type corresponding to an integral or enumeration type
+ *
+ * For enumerations, the member `type` is the underlying type. Otherwise, it is
+ * the type itself.
+ */
+template <
+    typename Type, ///< integral or enumeration type
+    bool = std::is_enum<Type>::value
+>
+struct integral_of {
+    typedef typename std::underlying_type<Type>::type type;
+};
+
+// Specialization for types which are not enumerations
+template <
+    typename Type
+>
+struct integral_of<Type, false> {
+    typedef Type type;
+};
+
+
+}
+
+
+/**
+ * Location of a bit field within an object
+ *
+ * A bit field consists of `Width` bits within an unsigned integral value of
+ * type `Storage`, starting at the bit `Bit`, where bit zero is the least
+ * significant one. The storage value is located at the byte offset `Offset`
+ * within the object and stored with the byte order `Order`. It needs not be
+ * aligned.
+ *
+ * Instances are passed to an attribute's `accessor()` in order to create an
+ * accessor for the bit field, e.g.:
+ *
+ *     flags_attr::accessor<header>(cmoh::bit_field<offsetof(header, flags), 3, 2>())
+ */
+template <
+    std::size_t Offset, ///< byte offset of the storage value within the object
+    unsigned int Bit, ///< first bit of the field within the storage value
+    unsigned int Width, ///< number of bits of the field
+    typename Storage = typename util::uint_least_bits<Bit + Width>::type, ///< storage type
+    byte_order Order = byte_order::native ///< byte order of the storage value
+>
+struct bit_field {};
+
+
+namespace accessors {
+namespace attribute {
+
+
+/**
+ * Attribute accessor for bit fields
+ *
+ * Access an attribute held in a range of bits at a compile time offset within
+ * the C++ type targeted. Like `by_offset`, this accessor is primarily included
+ * for legacy types and structs from C interfaces. Unlike C++ bit fields, the
+ * layout is fully specified via a `cmoh::bit_field`.
+ *
+ * Values of signed types are sign extended, values of enumerations are
+ * converted from and to their underlying type and boolean values are true if
+ * any bit is set. When setting a value, bits outside the field are preserved.
+ *
+ * Users are discouraged from constructing accessors directly. Use the
+ * `accessor()` overload provided by the attribute instead.
+ */
+template <
+    typename Attribute, ///< attribute type being accessed
+    typename ObjType, ///< type of the class or struct with the attribute
+    typename Value, ///< type as which the bits are interpreted
+    std::size_t Offset, ///< byte offset of the storage value within the object
+    unsigned int Bit, ///< first bit of the field within the storage value
+    unsigned int Width, ///< number of bits of the field
+    typename Storage, ///< unsigned integral type of the storage value
+    byte_order Order ///< byte order of the storage value
+>
+struct by_bits {
+    typedef Attribute property; ///< type of property being accessed
+    typedef ObjType object_type; ///< object being accessed
+    typedef Value value_type; ///< type as which the bits are interpreted
+    typedef Storage storage_type; ///< type of the storage value
+
+
+    static_assert(
+        std::is_unsigned<storage_type>::value,
+        "Storage type is not an unsigned integral type"
+    );
+    static_assert(
+        (Width > 0) && (Bit + Width <= std::numeric_limits<storage_type>::digits),
+        "Bit field exceeds storage type"
+    );
+    static_assert(
+        std::is_integral<value_type>::value || std::is_enum<value_type>::value,
+        "Bit fields must be interpreted as integral or enumeration types"
+    );
+    static_assert(
+        std::is_convertible<value_type, typename property::type>::value,
+        "Attribute type and real type not compatible."
+    );
+
+
+    /**
+     * Mask of the field's bits, shifted to the least significant bit
+     */
+    static constexpr storage_type mask =
+        static_cast<storage_type>(~storage_type(0)) >>
+        (std::numeric_limits<storage_type>::digits - Width);
+
+
+    by_bits() = default;
+    by_bits(by_bits const&) = default;
+    by_bits(by_bits&&) = default;
+
+    /**
+     * Get the attribute from an object
+     *
+     * \returns the attribute's value
+     */
+    typename property::type
+    get(
+        object_type const& obj ///< object from which to get the value
+    ) const {
+        return decode(util::load<storage_type, Order>(
+            reinterpret_cast<char const*>(&obj) + Offset
+        ));
+    }
+
+    /**
+     * Set the attribute on an object
+     */
+    void
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        typename property::type&& value ///< value to set
+    ) const {
+        auto location = reinterpret_cast<char*>(&obj) + Offset;
+        auto word = util::load<storage_type, Order>(location);
+        word = static_cast<storage_type>(
+            (word & ~static_cast<storage_type>(mask << Bit)) |
+            ((encode(static_cast<value_type>(value)) & mask) << Bit)
+        );
+        util::store<storage_type, Order>(location, word);
+    }
+
+    /**
+     * Get the attribute from a sequence of objects
+     *
+     * The values of the attribute of all objects in the range `[first, last)`
+     * are written to `out`. The loop consists only of loads, shifts and masks
+     * with a constant stride, which allows compilers to vectorize it, e.g. if
+     * `out` is a pointer.
+     *
+     * \returns the output iterator past the last value written
+     */
+    template <
+        typename OutputIterator ///< type of the output iterator
+    >
+    OutputIterator
+    extract(
+        object_type const* first, ///< first object
+        object_type const* last, ///< past the last object
+        OutputIterator out ///< iterator to which to write the values
+    ) const {
+        auto location = reinterpret_cast<char const*>(first) + Offset;
+        for (; first != last; ++first, ++out, location += sizeof(object_type))
+            *out = decode(util::load<storage_type, Order>(location));
+        return out;
+    }
+
+    /**
+     * Interpret a storage value
+     *
+     * \returns the value of the field within the storage value `word`
+     */
+    static
+    constexpr
+    value_type
+    decode(
+        storage_type word ///< storage value holding the field
+    ) noexcept {
+        return from_bits(
+            static_cast<storage_type>((word >> Bit) & mask),
+            category<value_type>()
+        );
+    }
+
+    /**
+     * Convert a value to bits
+     *
+     * \returns the value as bits, not yet masked or shifted into place
+     */
+    static
+    constexpr
+    storage_type
+    encode(
+        value_type value ///< value to convert
+    ) noexcept {
+        return to_bits(value, category<value_type>());
+    }
+
+
+private:
+    // tags for the kinds of types supported
+    struct boolean_tag {};
+    struct enum_tag {};
+    struct signed_tag {};
+    struct unsigned_tag {};
+
+    template <
+        typename T
+    >
+    using category = typename std::conditional<
+        std::is_same<T, bool>::value,
+        boolean_tag,
+        typename std::conditional<
+            std::is_enum<T>::value,
+            enum_tag,
+            typename std::conditional<
+                std::is_signed<T>::value,
+                signed_tag,
+                unsigned_tag
+            >::type
+        >::type
+    >::type;
+
+    typedef typename util::integral_of<value_type>::type integral_type;
+
+
+    static constexpr value_type from_bits(storage_type bits, boolean_tag) noexcept {
+        return bits != 0;
+    }
+
+    static constexpr value_type from_bits(storage_type bits, enum_tag) noexcept {
+        return static_cast<value_type>(
+            from_bits_integral(bits, category<integral_type>())
+        );
+    }
+
+    static constexpr value_type from_bits(storage_type bits, signed_tag) noexcept {
+        return from_bits_integral(bits, signed_tag());
+    }
+
+    static constexpr value_type from_bits(storage_type bits, unsigned_tag) noexcept {
+        return from_bits_integral(bits, unsigned_tag());
+    }
+
+    // sign extension via the most significant bit of the field
+    static constexpr integral_type from_bits_integral(
+        storage_type bits,
+        signed_tag
+    ) noexcept {
+        return static_cast<integral_type>(
+            static_cast<typename std::make_signed<storage_type>::type>(
+                static_cast<storage_type>(
+                    (bits ^ (storage_type(1) << (Width - 1))) -
+                    (storage_type(1) << (Width - 1))
+                )
+            )
+        );
+    }
+
+    static constexpr integral_type from_bits_integral(
+        storage_type bits,
+        unsigned_tag
+    ) noexcept {
+        return static_cast<integral_type>(bits);
+    }
+
+
+    static constexpr storage_type to_bits(value_type value, boolean_tag) noexcept {
+        return value ? 1 : 0;
+    }
+
+    static constexpr storage_type to_bits(value_type value, enum_tag) noexcept {
+        return static_cast<storage_type>(static_cast<integral_type>(value));
+    }
+
+    template <
+        typename Tag
+    >
+    static constexpr storage_type to_bits(value_type value, Tag) noexcept {
+        return static_cast<storage_type>(value);
+    }
+};
+
+template <
+    typename Attribute,
+    typename ObjType,
+    typename Value,
+    std::size_t Offset,
+    unsigned int Bit,
+    unsigned int Width,
+    typename Storage,
+    byte_order Order
+>
+constexpr typename by_bits<Attribute, ObjType, Value, Offset, Bit, Width, Storage, Order>::storage_type
+by_bits<Attribute, ObjType, Value, Offset, Bit, Width, Storage, Order>::mask;
+
+
+// accessor factory overlaod for the `cmoh::accessor::attribute::by_bits`
+template <
+    typename Attribute, ///< attribute being accessed
+    typename ObjType, ///< type of the class or struct with the attribute
+    typename Value, ///< type as which the bits are interpreted
+    std::size_t Offset, ///< byte offset of the storage value within the object
+    unsigned int Bit, ///< first bit of the field within the storage value
+    unsigned int Width, ///< number of bits of the field
+    typename Storage, ///< unsigned integral type of the storage value
+    byte_order Order ///< byte order of the storage value
+>
+constexpr
+by_bits<Attribute, ObjType, Value, Offset, Bit, Width, Storage, Order>
+make_accessor(
+    bit_field<Offset, Bit, Width, Storage, Order>
+) {
+    return by_bits<Attribute, ObjType, Value, Offset, Bit, Width, Storage, Order>();
+}
+
+
+}
+}
+}
+
+
+
+
+#endif
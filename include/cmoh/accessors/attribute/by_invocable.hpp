@@ -92,6 +92,28 @@ struct by_invocable_const {
         return util::invoke(_getter, obj);
     }
 
+    /**
+     * Get a reference to the attribute within an object
+     *
+     * This method is only available if the getter returns an lvalue reference.
+     *
+     * \returns the reference returned by the getter
+     */
+    template <
+        typename G = getter
+    >
+    typename std::enable_if<
+        std::is_lvalue_reference<
+            decltype(util::invoke(std::declval<G const&>(), std::declval<object_type const&>()))
+        >::value,
+        decltype(util::invoke(std::declval<G const&>(), std::declval<object_type const&>()))
+    >::type
+    ref(
+        object_type const& obj ///< object holding the value
+    ) const {
+        return util::invoke(_getter, obj);
+    }
+
 private:
     getter _getter;
 };
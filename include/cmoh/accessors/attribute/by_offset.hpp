@@ -30,7 +30,33 @@
 #include <type_traits>
 
 
+// local includes
+#include <cmoh/byte_order.hpp>
+
+
 namespace cmoh {
+
+
+/**
+ * Location of a value within a wire-mapped object
+ *
+ * The value is located at the byte offset `Offset` and stored with the byte
+ * order `Order`. It needs not be aligned.
+ *
+ * Instances are passed to an attribute's `accessor()` in order to create an
+ * accessor for the value, e.g.:
+ *
+ *     length_attr::accessor<header, std::uint16_t>(
+ *         cmoh::wire_offset<2, cmoh::byte_order::big>()
+ *     )
+ */
+template <
+    std::size_t Offset, ///< byte offset of the value within the object
+    byte_order Order = byte_order::native ///< byte order of the value
+>
+struct wire_offset {};
+
+
 namespace accessors {
 namespace attribute {
 
@@ -58,7 +84,7 @@ struct by_offset {
 
 
     static_assert(
-        std::is_convertible<object_type, typename property::type>::value,
+        std::is_convertible<value_type, typename property::type>::value,
         "Attribute type and real type not compatible."
     );
 
@@ -81,6 +107,20 @@ struct by_offset {
         );
     }
 
+    /**
+     * Get a reference to the attribute within an object
+     *
+     * \returns a reference to the attribute's value
+     */
+    value_type const&
+    ref(
+        object_type const& obj ///< object holding the value
+    ) const {
+        return *reinterpret_cast<value_type const*>(
+            reinterpret_cast<char const*>(&obj) + _offset
+        );
+    }
+
     /**
      * Set the attribute on an object
      */
@@ -100,6 +140,79 @@ private:
 };
 
 
+/**
+ * Attribute accessor for values in wire-mapped objects
+ *
+ * Access an attribute by a compile time offset within the C++ type targeted,
+ * e.g. a struct overlaid on a buffer received from the network or a mapped
+ * file. Unlike `by_offset`, values are loaded and stored via `std::memcpy()`,
+ * which is well defined for unaligned locations and compiles to plain loads
+ * and stores on targets supporting them. Values stored with a foreign byte
+ * order are swapped.
+ *
+ * For objects residing directly in such buffers, the C++ type targeted should
+ * have an alignment of one, e.g. by consisting of `unsigned char` arrays only.
+ *
+ * Users are discouraged from constructing accessors directly. Use the
+ * `accessor()` overload provided by the attribute instead.
+ */
+template <
+    typename Attribute, ///< attribute type being accessed
+    typename ObjType, ///< type of the class or struct with the attribute
+    typename Value, ///< type of the value in the object
+    std::size_t Offset, ///< byte offset of the value within the object
+    byte_order Order ///< byte order of the value
+>
+struct by_wire_offset {
+    typedef Attribute property; ///< type of property being accessed
+    typedef ObjType object_type; ///< object being accessed
+    typedef Value value_type; ///< actual type within the object
+
+
+    static_assert(
+        std::is_convertible<value_type, typename property::type>::value,
+        "Attribute type and real type not compatible."
+    );
+    static_assert(
+        Offset + sizeof(value_type) <= sizeof(object_type),
+        "Value exceeds object"
+    );
+
+
+    by_wire_offset() = default;
+    by_wire_offset(by_wire_offset const&) = default;
+    by_wire_offset(by_wire_offset&&) = default;
+
+    /**
+     * Get the attribute from an object
+     *
+     * \returns the attribute's value
+     */
+    typename property::type
+    get(
+        object_type const& obj ///< object from which to get the value
+    ) const {
+        return util::load<value_type, Order>(
+            reinterpret_cast<char const*>(&obj) + Offset
+        );
+    }
+
+    /**
+     * Set the attribute on an object
+     */
+    void
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        typename property::type&& value ///< value to set
+    ) const {
+        util::store<value_type, Order>(
+            reinterpret_cast<char*>(&obj) + Offset,
+            static_cast<value_type>(value)
+        );
+    }
+};
+
+
 // accessor factory overlaod for the `cmoh::accessor::attribute::by_offset`
 template <
     typename Attribute, ///< attribute being accessed
@@ -114,6 +227,22 @@ make_accessor(
     return by_offset<Attribute, ObjType, Value>(offset);
 }
 
+// accessor factory overlaod for the `cmoh::accessor::attribute::by_wire_offset`
+template <
+    typename Attribute, ///< attribute being accessed
+    typename ObjType, ///< type of the class or struct with the attribute
+    typename Value, ///< type of the value in the concrete C++ type
+    std::size_t Offset, ///< byte offset of the value within the object
+    byte_order Order ///< byte order of the value
+>
+constexpr
+by_wire_offset<Attribute, ObjType, Value, Offset, Order>
+make_accessor(
+    wire_offset<Offset, Order>
+) {
+    return by_wire_offset<Attribute, ObjType, Value, Offset, Order>();
+}
+
 
 }
 }
@@ -0,0 +1,352 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_ATTRIBUTE_MEMOIZED_HPP__
+#define CMOH_ATTRIBUTE_MEMOIZED_HPP__
+
+
+// std includes
+#include <chrono>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+
+// local includes
+#include <cmoh/accessors/utils.hpp>
+#include <cmoh/optional.hpp>
+#include <cmoh/utils.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Slot for memoizing a computed value within an object
+ *
+ * A memo holds an optional value along with the point in time at which it was
+ * stored. All operations are `const`, since memos are intended to be embedded
+ * as members into objects and modified via const references to those objects.
+ *
+ * Memos are not synchronized. Hence, they must not be accessed concurrently.
+ */
+template <
+    typename Type, ///< type of the value held
+    typename Clock = std::chrono::steady_clock ///< clock used for time stamps
+>
+class memo {
+public:
+    typedef Type value_type;
+    typedef Clock clock;
+
+
+    memo() = default;
+    memo(memo const&) = default;
+    memo(memo&&) = default;
+
+    memo& operator=(memo const&) = default;
+    memo& operator=(memo&&) = default;
+
+
+    /**
+     * Check whether the memo holds a value
+     */
+    bool
+    valid() const noexcept {
+        return _value.has_value();
+    }
+
+    /**
+     * Get the value held
+     *
+     * The memo must hold a value.
+     */
+    value_type const&
+    value() const noexcept {
+        return *_value;
+    }
+
+    /**
+     * Get the point in time at which the value was stored
+     */
+    typename clock::time_point
+    stamp() const noexcept {
+        return _stamp;
+    }
+
+    /**
+     * Store a value
+     */
+    void
+    store(
+        value_type value, ///< value to store
+        typename clock::time_point stamp = typename clock::time_point() ///< time stamp
+    ) const {
+        _value = std::move(value);
+        _stamp = stamp;
+    }
+
+    /**
+     * Discard the value held
+     */
+    void
+    invalidate() const noexcept {
+        _value.reset();
+    }
+
+private:
+    mutable optional<value_type> _value;
+    mutable typename clock::time_point _stamp;
+};
+
+
+namespace accessors {
+namespace attribute {
+
+
+/**
+ * Attribute accessor memoizing values computed by another accessor
+ *
+ * This accessor wraps a read-only accessor, e.g. a `by_invocable_const`, and
+ * stores the value retrieved in a `memo` embedded in the object. Subsequent
+ * retrievals return the stored value, until the memo is invalidated.
+ *
+ * The memo is retrieved from an object via the `Slot`, which is either a pointer
+ * to a data member of the object or an invocable taking the object.
+ *
+ * The attributes on which the value depends are declared via `Dependencies`.
+ * Accessor bundles invalidate the memo whenever one of those attributes is set
+ * through the bundle. Modifications carried out by other means do not
+ * invalidate the memo. Optionally, values may expire after a maximum age.
+ *
+ * Users are discouraged from constructing memoizing accessors directly. Use
+ * `cmoh::memoize()` instead.
+ */
+template <
+    typename Accessor, ///< accessor computing the value
+    typename Slot, ///< invocable retrieving the memo from an object
+    typename ...Dependencies ///< attributes on which the value depends
+>
+struct memoized {
+    typedef typename Accessor::property property; ///< property being accessed
+    typedef typename Accessor::object_type object_type; ///< object being accessed
+
+private:
+    // retrieve the memo via a pointer to a data member
+    template <
+        typename S
+    >
+    static
+    auto
+    memo_of(
+        S const& slot,
+        object_type const& obj,
+        std::true_type
+    ) -> decltype(obj.*slot) {
+        return obj.*slot;
+    }
+
+    // retrieve the memo via an invocable
+    template <
+        typename S
+    >
+    static
+    auto
+    memo_of(
+        S const& slot,
+        object_type const& obj,
+        std::false_type
+    ) -> decltype(util::invoke(slot, obj)) {
+        return util::invoke(slot, obj);
+    }
+
+public:
+    typedef typename std::decay<decltype(memo_of(
+        std::declval<Slot const&>(),
+        std::declval<object_type const&>(),
+        std::is_member_object_pointer<Slot>()
+    ))>::type memo_type; ///< type of the memo used
+    typedef typename memo_type::clock clock; ///< clock used for expiry
+
+
+    static_assert(
+        std::is_same<
+            typename memo_type::value_type,
+            typename std::remove_cv<typename property::type>::type
+        >::value,
+        "Memo type does not match attribute type"
+    );
+
+
+    /**
+     * Check whether the value depends on a specific attribute
+     *
+     * Instantiations provide a member `value` which is `true` if the attribute
+     * identified by `key` is one of the dependencies.
+     */
+    template <
+        typename property::key_type key ///< key of the attribute to check
+    >
+    using depends_on = util::disjunction<
+        accesses<Dependencies, typename property::key_type, key>...
+    >;
+
+
+    memoized(
+        Accessor accessor,
+        Slot slot,
+        typename clock::duration max_age = clock::duration::zero()
+    ) : _accessor(std::move(accessor)),
+        _slot(std::move(slot)),
+        _max_age(max_age) {}
+    memoized(memoized const&) = default;
+    memoized(memoized&&) = default;
+
+
+    /**
+     * Get the attribute from an object
+     *
+     * If the object's memo does not hold a valid value, the value will be
+     * computed using the wrapped accessor and stored in the memo.
+     *
+     * \returns the attribute's value
+     */
+    typename property::type
+    get(
+        object_type const& obj ///< object from which to get the value
+    ) const {
+        auto const& m = memo_of(_slot, obj, std::is_member_object_pointer<Slot>());
+
+        if (_max_age == clock::duration::zero()) {
+            if (!m.valid())
+                m.store(_accessor.get(obj));
+        } else {
+            // only query the clock if values may expire
+            auto const now = clock::now();
+            if (!m.valid() || (now - m.stamp() > _max_age))
+                m.store(_accessor.get(obj), now);
+        }
+
+        return m.value();
+    }
+
+    /**
+     * Invalidate the memoized value of an object
+     */
+    void
+    invalidate(
+        object_type const& obj ///< object of which to invalidate the value
+    ) const {
+        memo_of(_slot, obj, std::is_member_object_pointer<Slot>()).invalidate();
+    }
+
+    /**
+     * Check whether the value depends on an attribute given at run time
+     *
+     * \returns true if the attribute identified by `key` is a dependency
+     */
+    template <
+        typename KeyType ///< key type to use
+    >
+    bool
+    depends_on_key(
+        KeyType const& key ///< key of the attribute to check
+    ) const {
+        std::initializer_list<bool> matches = {(Dependencies::key() == key)...};
+        for (bool match : matches)
+            if (match)
+                return true;
+        return false;
+    }
+
+private:
+
+    Accessor _accessor;
+    Slot _slot;
+    typename clock::duration _max_age;
+};
+
+
+}
+}
+
+
+/**
+ * Create a memoizing accessor
+ *
+ * The accessor returned memoizes the values retrieved via the `accessor`
+ * supplied in the memo retrieved from objects via the `slot`. The memo will be
+ * invalidated by accessor bundles if one of the `Dependencies` is set. Use
+ * like:
+ *
+ *     cmoh::memoize<first_name_attr, last_name_attr>(
+ *         full_name_attr::accessor<person>(&get_full_name),
+ *         &person::full_name_memo
+ *     )
+ *
+ * \returns a memoizing accessor
+ */
+template <
+    typename ...Dependencies, ///< attributes on which the value depends
+    typename Accessor, ///< accessor computing the value
+    typename Slot ///< invocable retrieving the memo from an object
+>
+accessors::attribute::memoized<Accessor, Slot, Dependencies...>
+memoize(
+    Accessor accessor, ///< accessor computing the value
+    Slot slot ///< invocable retrieving the memo from an object
+) {
+    return accessors::attribute::memoized<Accessor, Slot, Dependencies...>(
+        std::move(accessor),
+        std::move(slot)
+    );
+}
+
+// overload for values expiring after some time
+template <
+    typename ...Dependencies,
+    typename Accessor,
+    typename Slot
+>
+accessors::attribute::memoized<Accessor, Slot, Dependencies...>
+memoize(
+    Accessor accessor,
+    Slot slot,
+    typename accessors::attribute::memoized<
+        Accessor,
+        Slot,
+        Dependencies...
+    >::clock::duration max_age ///< maximum age of memoized values
+) {
+    return accessors::attribute::memoized<Accessor, Slot, Dependencies...>(
+        std::move(accessor),
+        std::move(slot),
+        max_age
+    );
+}
+
+
+}
+
+
+#endif
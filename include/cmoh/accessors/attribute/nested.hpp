@@ -0,0 +1,179 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_ATTRIBUTE_NESTED_HPP__
+#define CMOH_ATTRIBUTE_NESTED_HPP__
+
+
+// std includes
+#include <type_traits>
+#include <utility>
+
+
+// local includes
+#include <cmoh/accessors/utils.hpp>
+
+
+namespace cmoh {
+namespace accessors {
+namespace attribute {
+
+
+/**
+ * Attribute accessor for nested objects
+ *
+ * This accessor wraps another attribute accessor for an attribute whose type
+ * has an accessor bundle of its own. It behaves like the wrapped accessor, but
+ * additionally exposes that bundle via `bundle()`. This allows addressing the
+ * nested object's attributes, e.g. via paths.
+ *
+ * If the wrapped accessor provides references to the values via `ref()`, so
+ * does this accessor.
+ *
+ * Users are discouraged from constructing nested accessors directly. Use
+ * `cmoh::nest()` instead.
+ */
+template <
+    typename Accessor, ///< accessor for the nested object
+    typename Bundle ///< accessor bundle for the nested object's type
+>
+struct nested {
+    typedef typename Accessor::property property; ///< property being accessed
+    typedef typename Accessor::object_type object_type; ///< object being accessed
+    typedef Bundle bundle_type; ///< bundle for the nested object
+
+
+    static_assert(
+        std::is_same<
+            typename std::decay<typename property::type>::type,
+            typename bundle_type::object_type
+        >::value,
+        "Bundle does not match attribute type"
+    );
+
+
+    nested(Accessor accessor, bundle_type bundle) :
+        _accessor(std::move(accessor)), _bundle(std::move(bundle)) {}
+    nested(nested const&) = default;
+    nested(nested&&) = default;
+
+
+    /**
+     * Get the attribute from an object
+     *
+     * \returns the attribute's value
+     */
+    typename property::type
+    get(
+        object_type const& obj ///< object from which to get the value
+    ) const {
+        return _accessor.get(obj);
+    }
+
+    /**
+     * Get a reference to the attribute within an object
+     *
+     * This method is only available if the wrapped accessor provides it.
+     *
+     * \returns a reference to the attribute's value
+     */
+    template <
+        typename A = Accessor
+    >
+    decltype(std::declval<A const&>().ref(std::declval<object_type const&>()))
+    ref(
+        object_type const& obj ///< object holding the value
+    ) const {
+        return _accessor.ref(obj);
+    }
+
+    /**
+     * Set the attribute on an object
+     *
+     * This method is only available if the wrapped accessor provides it.
+     */
+    template <
+        typename A = Accessor
+    >
+    decltype(std::declval<A const&>().set(
+        std::declval<object_type&>(),
+        std::declval<typename property::type&&>()
+    ))
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        typename property::type&& value ///< value to set
+    ) const {
+        _accessor.set(obj, std::forward<typename property::type>(value));
+    }
+
+    /**
+     * Get the accessor bundle for the nested object
+     */
+    bundle_type const&
+    bundle() const noexcept {
+        return _bundle;
+    }
+
+private:
+    Accessor _accessor;
+    bundle_type _bundle;
+};
+
+
+}
+}
+
+
+/**
+ * Create an accessor for a nested object
+ *
+ * The accessor returned behaves like the `accessor` supplied, but exposes the
+ * `bundle` for the nested object's type. Use like:
+ *
+ *     cmoh::nest(
+ *         address_attr::accessor<person>(&person::address),
+ *         address_accessors
+ *     )
+ *
+ * \returns an accessor for the nested object
+ */
+template <
+    typename Accessor, ///< accessor for the nested object
+    typename Bundle ///< accessor bundle for the nested object's type
+>
+accessors::attribute::nested<Accessor, Bundle>
+nest(
+    Accessor accessor, ///< accessor for the nested object
+    Bundle bundle ///< accessor bundle for the nested object's type
+) {
+    return accessors::attribute::nested<Accessor, Bundle>(
+        std::move(accessor),
+        std::move(bundle)
+    );
+}
+
+
+}
+
+
+#endif
@@ -26,6 +26,7 @@
 
 
 // std includes
+#include <new>
 #include <utility>
 
 // local includes
@@ -64,6 +65,50 @@ struct constructor : abstract_factory<Attributes...> {
             )...
         };
     }
+
+    /**
+     * Construct an object in the storage supplied
+     *
+     * The storage must be suitably sized and aligned for an `object_type`.
+     *
+     * \returns a pointer to the object constructed
+     */
+    template <
+        typename ...PassedAttributes ///< attrbiutes availible for construction
+    >
+    object_type*
+    create_at(
+        void* storage, ///< storage in which to construct the object
+        typename PassedAttributes::type&&... arguments
+    ) const {
+        return new (storage) object_type{
+            Attributes::template select<PassedAttributes...>(
+                std::forward<typename PassedAttributes::type>(arguments)...
+            )...
+        };
+    }
+
+    /**
+     * Construct an object at the end of a container
+     *
+     * The object is constructed via the container's `emplace_back()`, which
+     * invokes the constructor using parentheses.
+     */
+    template <
+        typename ...PassedAttributes, ///< attrbiutes availible for construction
+        typename Container ///< type of the container
+    >
+    void
+    emplace_into(
+        Container& container, ///< container to which to append the object
+        typename PassedAttributes::type&&... arguments
+    ) const {
+        container.emplace_back(
+            Attributes::template select<PassedAttributes...>(
+                std::forward<typename PassedAttributes::type>(arguments)...
+            )...
+        );
+    }
 };
 
 
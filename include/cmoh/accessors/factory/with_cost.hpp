@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_ACCESSORS_FACTORY_WITH_COST_HPP__
+#define CMOH_ACCESSORS_FACTORY_WITH_COST_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <utility>
+
+
+namespace cmoh {
+namespace accessors {
+namespace factory {
+
+
+/**
+ * Factory with a user-declared cost
+ *
+ * This template wraps a factory and declares an additional cost of using it,
+ * which is taken into account by accessor bundles when selecting a factory.
+ * The cost is expressed in units of post-construction setter calls, e.g. a
+ * cost of 2 makes the factory as expensive as one requiring two more setter
+ * calls.
+ *
+ * Users are discouraged from constructing these factories directly. Use
+ * `cmoh::with_cost()` instead.
+ */
+template <
+    typename Factory, ///< factory to wrap
+    std::size_t Cost ///< additional cost of using the factory
+>
+struct with_cost : Factory {
+    static constexpr std::size_t cost = Cost;
+
+    with_cost(Factory factory) : Factory(std::move(factory)) {}
+    with_cost(with_cost const&) = default;
+    with_cost(with_cost&&) = default;
+};
+
+// definition of the static member, required if it is odr-used
+template <
+    typename Factory,
+    std::size_t Cost
+>
+constexpr std::size_t with_cost<Factory, Cost>::cost;
+
+
+}
+}
+
+
+/**
+ * Declare an additional cost for using a factory
+ *
+ * \returns a factory with the cost supplied
+ */
+template <
+    std::size_t Cost, ///< additional cost of using the factory
+    typename Factory ///< factory to wrap
+>
+accessors::factory::with_cost<Factory, Cost>
+with_cost(
+    Factory factory ///< factory to wrap
+) {
+    return accessors::factory::with_cost<Factory, Cost>(std::move(factory));
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_METHOD_BY_INVOCABLE_HPP__
+#define CMOH_METHOD_BY_INVOCABLE_HPP__
+
+
+// std includes
+#include <type_traits>
+#include <utility>
+
+
+// local includes
+#include <cmoh/utils.hpp>
+
+
+namespace cmoh {
+namespace accessors {
+namespace method {
+
+
+/**
+ * Method accessor using invocables
+ *
+ * This accessor invokes a method on the target C++ struct/class via an
+ * invocable, e.g. a pointer to a member function or a function taking the
+ * object as its first argument.
+ *
+ * Users are discouraged from constructing method accessors directly. Use
+ * the `accessor()` method provided by the method instead.
+ */
+template <
+    typename Method, ///< method being accessed
+    typename ObjType, ///< type of the class or struct with the method
+    typename Invocable, ///< type of the invocable
+    typename Signature = typename Method::signature ///< signature of the method
+>
+struct by_invocable;
+
+// Specialization for function signatures
+template <
+    typename Method,
+    typename ObjType,
+    typename Invocable,
+    typename Result,
+    typename ...Args
+>
+struct by_invocable<Method, ObjType, Invocable, Result(Args...)> {
+    typedef Method property; ///< type of property being accessed
+    typedef ObjType object_type; ///< object being accessed
+
+    typedef Invocable invocable; // type of the invocable used
+
+
+    static_assert(
+        util::is_invocable<invocable, object_type&, Args...>::value,
+        "Invocable not invokable with object and arguments"
+    );
+
+
+    by_invocable(invocable&& i) : _invocable(std::forward<invocable>(i)) {};
+    by_invocable(by_invocable const&) = default;
+    by_invocable(by_invocable&&) = default;
+
+
+    /**
+     * Invoke the method on an object
+     *
+     * \returns the value returned by the method
+     */
+    Result
+    invoke(
+        object_type& obj, ///< object on which to invoke the method
+        Args... args ///< arguments passed to the method
+    ) const {
+        return static_cast<Result>(
+            util::invoke(_invocable, obj, std::forward<Args>(args)...)
+        );
+    }
+
+private:
+    invocable _invocable;
+};
+
+
+/**
+ * Construct a method accessor from an invocable
+ */
+template <
+    typename Method, ///< method being accessed
+    typename ObjType, ///< type of the class or struct with the method
+    typename Invocable ///< type of the invocable
+>
+constexpr
+by_invocable<Method, ObjType, Invocable>
+make_accessor(
+    Invocable&& invocable
+) {
+    return by_invocable<Method, ObjType, Invocable>(
+        std::forward<Invocable>(invocable)
+    );
+}
+
+
+}
+}
+}
+
+
+
+#endif
@@ -26,10 +26,12 @@
 
 
 // std includes
+#include <cstddef>
 #include <type_traits>
 
 
 // local includes
+#include <cmoh/properties.hpp>
 #include <cmoh/utils.hpp>
 
 
@@ -75,6 +77,26 @@ struct is_factory<
 > : std::true_type {};
 
 
+/**
+ * Query the cost declared by a factory
+ *
+ * Provides the member `value`, which holds the value of the static member
+ * `cost` of the factory or zero, if the factory does not declare a cost.
+ */
+template <
+    typename Accessor, ///< factory to query
+    typename = void
+>
+struct declared_cost : std::integral_constant<std::size_t, 0> {};
+
+// Specialization for factories declaring a cost
+template <
+    typename Accessor
+>
+struct declared_cost<Accessor, util::void_t<decltype(Accessor::cost)>> :
+    std::integral_constant<std::size_t, Accessor::cost> {};
+
+
 /**
  * Check whether a supposed accessor is an attribute accessor
  *
@@ -99,6 +121,157 @@ struct is_attribute_accessor<
 > : std::true_type {};
 
 
+/**
+ * Check whether an attribute accessor provides references to values
+ *
+ * Such an accessor has a method `ref()` which accepts a const reference to an
+ * object of the contained object_type and returns a const reference to the
+ * attribute's value within that object.
+ */
+template <
+    typename Accessor, ///< accessor to check
+    typename = void
+>
+struct is_referenceable : std::false_type {};
+
+// Specialization for referenceable accessors
+template <
+    typename Accessor
+>
+struct is_referenceable<
+    Accessor,
+    util::void_t<decltype(std::declval<Accessor const&>().ref(
+            std::declval<typename Accessor::object_type const&>()
+    ))>
+> : std::true_type {};
+
+
+/**
+ * Check whether a supposed accessor accesses a nested object
+ *
+ * An accessor for a nested object has a method `bundle()` returning the
+ * accessor bundle for the attribute's type.
+ */
+template <
+    typename Accessor, ///< accessor to check
+    typename = void
+>
+struct is_nested : std::false_type {};
+
+// Specialization for accessors of nested objects
+template <
+    typename Accessor
+>
+struct is_nested<
+    Accessor,
+    util::void_t<decltype(std::declval<Accessor const&>().bundle())>
+> : std::true_type {};
+
+
+/**
+ * Check whether a supposed accessor is a method accessor
+ *
+ * A method accessor accesses a method, e.g. a `cmoh::method`, and has a method
+ * `invoke()` which accepts an object of the contained object_type followed by
+ * the method's arguments.
+ */
+template <
+    typename Accessor, ///< accessor to check
+    typename = void
+>
+struct is_method_accessor : std::false_type {};
+
+// Specialization for method accessors
+template <
+    typename Accessor
+>
+struct is_method_accessor<
+    Accessor,
+    util::void_t<typename Accessor::property>
+> : properties::is_method<typename Accessor::property> {};
+
+
+/**
+ * Check whether a supposed accessor is an accessor for a settable attribute
+ *
+ * A settable attribute's accessor has a method `set()` which accepts an object
+ * of the contained object_type and an rvalue of the attribute's type.
+ */
+template <
+    typename Accessor, ///< accessor to check
+    typename = void
+>
+struct is_settable : std::false_type {};
+
+// Specialization for settable attributes
+template <
+    typename Accessor
+>
+struct is_settable<
+    Accessor,
+    util::void_t<decltype(std::declval<Accessor const&>().set(
+            std::declval<typename Accessor::object_type&>(),
+            std::declval<typename Accessor::property::type&&>()
+    ))>
+> : std::true_type {};
+
+
+/**
+ * Check whether a supposed accessor caches values which may be invalidated
+ *
+ * Such an accessor has a method `invalidate()` which accepts a const reference
+ * to an object of the contained object_type and a method `depends_on_key()`
+ * accepting a key.
+ */
+template <
+    typename Accessor, ///< accessor to check
+    typename = void
+>
+struct is_invalidatable : std::false_type {};
+
+// Specialization for invalidatable accessors
+template <
+    typename Accessor
+>
+struct is_invalidatable<
+    Accessor,
+    util::void_t<decltype(std::declval<Accessor const&>().invalidate(
+            std::declval<typename Accessor::object_type const&>()
+    ))>
+> : std::true_type {};
+
+
+/**
+ * Check whether an accessor's cached values depend on a specific attribute
+ *
+ * Provides the member `value`, which is true if the accessor is invalidatable
+ * and declares a dependency on the attribute identified by `key` via its
+ * member template `depends_on`.
+ */
+template <
+    typename Accessor, ///< accessor to check
+    typename KeyType, ///< key type to use
+    KeyType key ///< key of the attribute
+>
+struct depends_on {
+private:
+    template <
+        typename T,
+        typename = void
+    >
+    struct helper : std::false_type {};
+
+    template <
+        typename T
+    >
+    struct helper<T, util::void_t<typename T::template depends_on<key>>> :
+        T::template depends_on<key> {};
+
+public:
+    enum : bool {value = helper<Accessor>::value};
+};
+
+
 /**
  * Query the property associated with an accessor
  *
@@ -0,0 +1,348 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_ARENA_HPP__
+#define CMOH_ARENA_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+
+namespace cmoh {
+
+
+/**
+ * Monotonic arena for bulk creation of objects
+ *
+ * An arena hands out memory by advancing a pointer within a block. If a block
+ * is exhausted, a new block twice the size of the previous one is allocated.
+ * Memory is never freed individually. Instead, all objects adopted by the arena
+ * are destroyed and all blocks are freed at once by `release()` or when the
+ * arena is destroyed.
+ *
+ * Optionally, a caller-supplied buffer is used before any block is allocated.
+ * That buffer is not freed by the arena and must outlive it.
+ *
+ * Accessor bundles create objects in arenas via `create_in()`. Values of
+ * attributes whose types are allocator-aware and accept an `arena_allocator`
+ * will be rebuilt using the arena's allocator in the process.
+ *
+ * Arenas are not synchronized and can neither be copied nor moved.
+ */
+class arena {
+public:
+    /**
+     * Allocator handing out memory from an arena
+     */
+    template <
+        typename Type ///< type of the objects to allocate
+    >
+    class allocator;
+
+    typedef allocator<unsigned char> allocator_type;
+
+
+    explicit arena(std::size_t block_size = 4096) noexcept :
+        _block_size(block_size) {}
+    arena(void* buffer, std::size_t size, std::size_t block_size = 4096) noexcept :
+        _pos(static_cast<unsigned char*>(buffer)),
+        _end(static_cast<unsigned char*>(buffer) + size),
+        _buffer(static_cast<unsigned char*>(buffer)),
+        _buffer_size(size),
+        _block_size(block_size) {}
+    arena(arena const&) = delete;
+    arena(arena&&) = delete;
+
+    ~arena() {
+        release();
+    }
+
+    arena& operator=(arena const&) = delete;
+    arena& operator=(arena&&) = delete;
+
+
+    /**
+     * Allocate memory from the arena
+     *
+     * \returns a pointer to memory of at least `size` bytes
+     */
+    void*
+    allocate(
+        std::size_t size, ///< number of bytes to allocate
+        std::size_t alignment = alignof(std::max_align_t) ///< alignment
+    ) {
+        // the padding may exceed the space left, so we compare sizes only
+        auto const remaining = static_cast<std::size_t>(_end - _pos);
+        auto padding = padding_for(_pos, alignment);
+        if (!_pos || (padding > remaining) || (remaining - padding < size)) {
+            grow(size + alignment);
+            padding = padding_for(_pos, alignment);
+        }
+        auto const retval = _pos + padding;
+        _pos = retval + size;
+        return retval;
+    }
+
+    /**
+     * Reserve the bookkeeping needed for adopting an object
+     *
+     * After a call to this method, the next adoption of an object will not
+     * allocate and hence not throw. Use this method before constructing an
+     * object which is to be adopted, so it is not leaked if the arena fails to
+     * allocate. For trivially destructible objects, this method has no effect.
+     */
+    template <
+        typename Type ///< type of the object to adopt
+    >
+    void
+    reserve_adoption() {
+        reserve_cleanup(std::is_trivially_destructible<Type>());
+    }
+
+    /**
+     * Let the arena destroy an object constructed in its memory on release
+     *
+     * Objects are destroyed in the reverse order of their adoption. Adopting
+     * trivially destructible objects has no effect.
+     *
+     * \returns the object adopted
+     */
+    template <
+        typename Type ///< type of the object to adopt
+    >
+    Type*
+    adopt(
+        Type* object ///< object to adopt
+    ) {
+        register_cleanup(object, std::is_trivially_destructible<Type>());
+        return object;
+    }
+
+    /**
+     * Destroy all adopted objects and free all memory allocated
+     *
+     * The arena may be used again afterwards.
+     */
+    void
+    release() noexcept {
+        while (_cleanups) {
+            auto current = _cleanups;
+            _cleanups = current->next;
+            current->destroy(current->object);
+        }
+
+        while (_blocks) {
+            auto current = _blocks;
+            _blocks = current->next;
+            ::operator delete(current);
+        }
+
+        _pos = _buffer;
+        _end = _buffer + _buffer_size;
+        _spare = nullptr;
+    }
+
+
+    /**
+     * Get an allocator handing out memory from this arena
+     */
+    allocator_type
+    get_allocator() noexcept;
+
+
+private:
+    struct block {
+        block* next;
+    };
+
+    struct cleanup {
+        cleanup* next;
+        void (*destroy)(void*);
+        void* object;
+    };
+
+
+    // number of bytes to skip for aligning a position
+    static
+    std::size_t
+    padding_for(
+        unsigned char* pos,
+        std::size_t alignment
+    ) noexcept {
+        auto const address = reinterpret_cast<std::uintptr_t>(pos);
+        return (alignment - address % alignment) % alignment;
+    }
+
+    void
+    grow(
+        std::size_t min_size
+    ) {
+        auto size = _block_size;
+        while (size < min_size + sizeof(block))
+            size *= 2;
+
+        auto const fresh = static_cast<block*>(::operator new(size));
+        fresh->next = _blocks;
+        _blocks = fresh;
+
+        _pos = reinterpret_cast<unsigned char*>(fresh) + sizeof(block);
+        _end = reinterpret_cast<unsigned char*>(fresh) + size;
+        _block_size = size * 2;
+    }
+
+    void
+    reserve_cleanup(
+        std::true_type
+    ) noexcept {}
+
+    void
+    reserve_cleanup(
+        std::false_type
+    ) {
+        if (!_spare)
+            _spare = static_cast<cleanup*>(
+                allocate(sizeof(cleanup), alignof(cleanup))
+            );
+    }
+
+    template <
+        typename Type
+    >
+    void
+    register_cleanup(
+        Type*,
+        std::true_type
+    ) noexcept {}
+
+    template <
+        typename Type
+    >
+    void
+    register_cleanup(
+        Type* object,
+        std::false_type
+    ) {
+        reserve_cleanup(std::false_type());
+        auto const entry = _spare;
+        _spare = nullptr;
+        entry->next = _cleanups;
+        entry->destroy = [] (void* obj) { static_cast<Type*>(obj)->~Type(); };
+        entry->object = object;
+        _cleanups = entry;
+    }
+
+
+    unsigned char* _pos = nullptr;
+    unsigned char* _end = nullptr;
+    unsigned char* _buffer = nullptr;
+    std::size_t _buffer_size = 0;
+    std::size_t _block_size;
+    block* _blocks = nullptr;
+    cleanup* _cleanups = nullptr;
+    cleanup* _spare = nullptr;
+};
+
+
+template <
+    typename Type
+>
+class arena::allocator {
+public:
+    typedef Type value_type;
+
+
+    allocator(arena& source) noexcept : _arena(&source) {}
+    template <
+        typename Other
+    >
+    allocator(allocator<Other> const& other) noexcept : _arena(other._arena) {}
+
+
+    Type*
+    allocate(
+        std::size_t n
+    ) {
+        return static_cast<Type*>(_arena->allocate(n*sizeof(Type), alignof(Type)));
+    }
+
+    void
+    deallocate(
+        Type*,
+        std::size_t
+    ) noexcept {}
+
+
+    template <
+        typename Other
+    >
+    bool
+    operator == (
+        allocator<Other> const& other
+    ) const noexcept {
+        return _arena == other._arena;
+    }
+
+    template <
+        typename Other
+    >
+    bool
+    operator != (
+        allocator<Other> const& other
+    ) const noexcept {
+        return _arena != other._arena;
+    }
+
+private:
+    template <
+        typename
+    >
+    friend class allocator;
+
+    arena* _arena;
+};
+
+
+inline
+arena::allocator_type
+arena::get_allocator() noexcept {
+    return allocator_type(*this);
+}
+
+
+/**
+ * Allocator handing out memory from an arena
+ */
+template <
+    typename Type ///< type of the objects to allocate
+>
+using arena_allocator = arena::allocator<Type>;
+
+
+}
+
+
+#endif
@@ -31,6 +31,7 @@
 
 
 // local includes
+#include <cmoh/accessors/attribute/by_bits.hpp>
 #include <cmoh/accessors/attribute/by_invocable.hpp>
 #include <cmoh/accessors/attribute/by_offset.hpp>
 
@@ -0,0 +1,233 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_BYTE_ORDER_HPP__
+#define CMOH_BYTE_ORDER_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace cmoh {
+
+
+/**
+ * Byte order of values in memory
+ *
+ * `native` is the byte order of the target, which is detected via the
+ * `__BYTE_ORDER__` macro if available. Little endian is assumed otherwise.
+ */
+enum class byte_order {
+    little,
+    big,
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    native = big
+#else
+    native = little
+#endif
+};
+
+
+namespace util {
+
+
+/**
+ * Smallest unsigned integral type holding a number of bits
+ *
+ * The type is exported as the member `type`.
+ */
+template <
+    unsigned int Bits ///< number of bits to hold
+>
+struct uint_least_bits {
+    static_assert(Bits <= 64, "No unsigned type holds the number of bits");
+
+    typedef typename std::conditional<
+        (Bits <= 8),
+        std::uint8_t,
+        typename std::conditional<
+            (Bits <= 16),
+            std::uint16_t,
+            typename std::conditional<
+                (Bits <= 32),
+                std::uint32_t,
+                std::uint64_t
+            >::type
+        >::type
+    >::type type;
+};
+
+
+/**
+ * Reverse the bytes of an unsigned integral value
+ *
+ * Compiler builtins are used if available. Otherwise, the bytes are reversed
+ * via shifts, which compilers usually recognize.
+ *
+ * \returns the value with its bytes reversed
+ */
+template <
+    typename Value ///< unsigned integral type
+>
+constexpr
+typename std::enable_if<sizeof(Value) == 1, Value>::type
+byte_swap(
+    Value value ///< value to swap
+) noexcept {
+    return value;
+}
+
+template <
+    typename Value
+>
+constexpr
+typename std::enable_if<(sizeof(Value) > 1), Value>::type
+byte_swap(
+    Value value
+) noexcept {
+    static_assert(std::is_unsigned<Value>::value, "Value is not unsigned");
+#if defined(__GNUC__)
+    return sizeof(Value) == 2 ? static_cast<Value>(__builtin_bswap16(value)) :
+           sizeof(Value) == 4 ? static_cast<Value>(__builtin_bswap32(value)) :
+           static_cast<Value>(__builtin_bswap64(value));
+#else
+    Value retval = 0;
+    for (std::size_t i = 0; i < sizeof(Value); ++i) {
+        retval = static_cast<Value>((retval << 8) | (value & 0xff));
+        value = static_cast<Value>(value >> 8);
+    }
+    return retval;
+#endif
+}
+
+
+/**
+ * Load a value stored with a specific byte order
+ *
+ * The value is loaded via `std::memcpy()`. Hence, the location needs not be
+ * aligned. Values of trivially copyable types may be loaded in the native byte
+ * order. Other byte orders are only supported for arithmetic and enumeration
+ * types, whose bytes are reversed after loading.
+ *
+ * \returns the value loaded
+ */
+template <
+    typename Value, ///< type of the value to load
+    byte_order Order = byte_order::native ///< byte order in memory
+>
+typename std::enable_if<
+    (Order == byte_order::native) || (sizeof(Value) == 1),
+    Value
+>::type
+load(
+    void const* location ///< location of the value
+) noexcept {
+    static_assert(
+        std::is_trivially_copyable<Value>::value,
+        "Value is not trivially copyable"
+    );
+    Value retval;
+    std::memcpy(&retval, location, sizeof(retval));
+    return retval;
+}
+
+// overload for values with a foreign byte order
+template <
+    typename Value,
+    byte_order Order = byte_order::native
+>
+typename std::enable_if<
+    (Order != byte_order::native) && (sizeof(Value) > 1),
+    Value
+>::type
+load(
+    void const* location
+) noexcept {
+    static_assert(
+        std::is_arithmetic<Value>::value || std::is_enum<Value>::value,
+        "Byte order is only defined for arithmetic and enumeration types"
+    );
+    typedef typename uint_least_bits<8 * sizeof(Value)>::type bits;
+    static_assert(sizeof(bits) == sizeof(Value), "Unsupported size of value");
+
+    auto swapped = byte_swap(load<bits>(location));
+    Value retval;
+    std::memcpy(&retval, &swapped, sizeof(retval));
+    return retval;
+}
+
+
+/**
+ * Store a value with a specific byte order
+ *
+ * The value is stored via `std::memcpy()`. Hence, the location needs not be
+ * aligned. The same restrictions as for `load()` apply.
+ */
+template <
+    typename Value, ///< type of the value to store
+    byte_order Order = byte_order::native ///< byte order in memory
+>
+typename std::enable_if<(Order == byte_order::native) || (sizeof(Value) == 1)>::type
+store(
+    void* location, ///< location of the value
+    Value const& value ///< value to store
+) noexcept {
+    static_assert(
+        std::is_trivially_copyable<Value>::value,
+        "Value is not trivially copyable"
+    );
+    std::memcpy(location, &value, sizeof(value));
+}
+
+// overload for values with a foreign byte order
+template <
+    typename Value,
+    byte_order Order = byte_order::native
+>
+typename std::enable_if<(Order != byte_order::native) && (sizeof(Value) > 1)>::type
+store(
+    void* location,
+    Value const& value
+) noexcept {
+    static_assert(
+        std::is_arithmetic<Value>::value || std::is_enum<Value>::value,
+        "Byte order is only defined for arithmetic and enumeration types"
+    );
+    typedef typename uint_least_bits<8 * sizeof(Value)>::type bits;
+    static_assert(sizeof(bits) == sizeof(Value), "Unsupported size of value");
+
+    bits raw;
+    std::memcpy(&raw, &value, sizeof(raw));
+    store<bits>(location, byte_swap(raw));
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,417 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_DISPATCHER_HPP__
+#define CMOH_DISPATCHER_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// local includes
+#include <cmoh/encoding.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Dispatcher for method calls encoded in a buffer
+ *
+ * A dispatcher invokes the methods accessible via an accessor bundle on behalf
+ * of calls encoded as bytes, e.g. received via some transport. A call consists
+ * of the method's index, as returned by the bundle's `method_index()`, encoded
+ * as a varint, followed by the arguments, each encoded using
+ * `cmoh::encoding::codec`. Calls may be encoded via `encode_call()`.
+ *
+ * The dispatcher decodes the arguments directly from the buffer and calls
+ * the method through a table of plain function pointers, indexed by the
+ * method's index. The table is built at compile time. Hence, dispatching a
+ * call involves a single indirect call, without any virtual functions or
+ * lookups by key. The value returned by the method, if any, is appended to a
+ * response buffer in the same encoding.
+ *
+ * Dispatchers hold a reference to the bundle they were created with. Hence,
+ * the bundle has to outlive them.
+ */
+template <
+    typename Bundle ///< accessor bundle providing the methods
+>
+class dispatcher {
+public:
+    typedef typename Bundle::key_type key_type;
+    typedef typename Bundle::object_type object_type;
+    typedef encoding::byte byte;
+
+    /**
+     * Function handling a call of a single method
+     */
+    typedef bool (*handler)(
+        Bundle const& bundle,
+        object_type& obj,
+        byte const*& pos,
+        byte const* end,
+        std::vector<byte>& response
+    );
+
+    /**
+     * Number of methods dispatched
+     */
+    static constexpr std::size_t size = Bundle::method_count;
+
+    static_assert(size > 0, "Bundle does not provide any methods");
+
+
+    explicit dispatcher(Bundle const& bundle) : _bundle(bundle) {}
+    dispatcher(dispatcher const&) = default;
+    dispatcher(dispatcher&&) = default;
+
+
+    /**
+     * Append a call of a specific method to a buffer
+     *
+     * The arguments are converted to the types of the method's parameters.
+     */
+    template <
+        key_type key, ///< key of the method to call
+        typename ...Args ///< types of the arguments
+    >
+    static
+    void
+    encode_call(
+        std::vector<byte>& buffer, ///< buffer to which to append the call
+        Args const&... args ///< arguments to pass
+    ) {
+        typedef typename Bundle::template property_by_key<key> method;
+        static_assert(
+            sizeof...(Args) == method::arity,
+            "Number of arguments does not match the method's arity"
+        );
+
+        encoding::write_varint(buffer, Bundle::template method_index<key>());
+        encode_arguments<typename method::arguments>(
+            buffer,
+            std::index_sequence_for<Args...>(),
+            args...
+        );
+    }
+
+    /**
+     * Decode the value returned by a call of a specific method
+     *
+     * On success, `pos` is advanced past the value.
+     *
+     * \returns true if the value could be decoded, false otherwise
+     */
+    template <
+        key_type key ///< key of the method called
+    >
+    static
+    bool
+    decode_result(
+        byte const*& pos, ///< position from which to read the value
+        byte const* end, ///< end of the buffer
+        typename std::decay<
+            typename Bundle::template property_by_key<key>::result_type
+        >::type& value ///< value decoded
+    ) {
+        return encoding::codec<
+            typename std::decay<
+                typename Bundle::template property_by_key<key>::result_type
+            >::type
+        >::decode(pos, end, value);
+    }
+
+
+    /**
+     * Dispatch a call of the method with a specific index
+     *
+     * The arguments are decoded starting at `pos`. On success, `pos` is
+     * advanced past the arguments and the value returned by the method, if
+     * any, is appended to the `response`.
+     *
+     * \returns true if the method was invoked, false if the index is out of
+     *          range or the arguments are malformed
+     */
+    bool
+    dispatch(
+        object_type& obj, ///< object on which to invoke the method
+        std::size_t id, ///< index of the method to invoke
+        byte const*& pos, ///< position from which to read the arguments
+        byte const* end, ///< end of the buffer
+        std::vector<byte>& response ///< buffer for the value returned
+    ) const {
+        if (id >= size)
+            return false;
+
+        auto current = pos;
+        if (!table(std::make_index_sequence<size>())[id](
+            _bundle,
+            obj,
+            current,
+            end,
+            response
+        ))
+            return false;
+        pos = current;
+        return true;
+    }
+
+    /**
+     * Dispatch a call encoded via `encode_call()`
+     *
+     * \returns true if the method was invoked, false if the call is malformed
+     */
+    bool
+    dispatch(
+        object_type& obj, ///< object on which to invoke the method
+        byte const*& pos, ///< position from which to read the call
+        byte const* end, ///< end of the buffer
+        std::vector<byte>& response ///< buffer for the value returned
+    ) const {
+        auto current = pos;
+        std::uint64_t id;
+        if (!encoding::read_varint(current, end, id) || (id >= size))
+            return false;
+        if (!dispatch(obj, static_cast<std::size_t>(id), current, end, response))
+            return false;
+        pos = current;
+        return true;
+    }
+
+
+private:
+    template <
+        typename Params,
+        std::size_t ...indices,
+        typename ...Args
+    >
+    static
+    void
+    encode_arguments(
+        std::vector<byte>& buffer,
+        std::index_sequence<indices...>,
+        Args const&... args
+    ) {
+        (void) std::initializer_list<int>{0, (encoding::codec<
+            typename std::decay<
+                typename std::tuple_element<indices, Params>::type
+            >::type
+        >::encode(buffer, args), 0)...};
+    }
+
+
+    /**
+     * Decoding of arguments and invocation of a method
+     *
+     * The arguments of the types in `Params` are decoded one by one and passed
+     * on. Once all arguments are decoded, the method is invoked.
+     */
+    template <
+        typename Accessor,
+        typename Params
+    >
+    struct invoker;
+
+    template <
+        typename Accessor,
+        typename Param0,
+        typename ...Params
+    >
+    struct invoker<Accessor, std::tuple<Param0, Params...>> {
+        template <
+            typename ...Values
+        >
+        static
+        bool
+        call(
+            Accessor const& accessor,
+            object_type& obj,
+            byte const*& pos,
+            byte const* end,
+            std::vector<byte>& response,
+            Values&&... values
+        ) {
+            typedef typename std::decay<Param0>::type value_type;
+
+            value_type value;
+            if (!encoding::codec<value_type>::decode(pos, end, value))
+                return false;
+            return invoker<Accessor, std::tuple<Params...>>::call(
+                accessor,
+                obj,
+                pos,
+                end,
+                response,
+                std::forward<Values>(values)...,
+                std::move(value)
+            );
+        }
+    };
+
+    template <
+        typename Accessor
+    >
+    struct invoker<Accessor, std::tuple<>> {
+        typedef typename Accessor::property::result_type result_type;
+
+        template <
+            typename ...Values
+        >
+        static
+        bool
+        call(
+            Accessor const& accessor,
+            object_type& obj,
+            byte const*&,
+            byte const*,
+            std::vector<byte>& response,
+            Values&&... values
+        ) {
+            respond(
+                std::is_void<result_type>(),
+                accessor,
+                obj,
+                response,
+                std::forward<Values>(values)...
+            );
+            return true;
+        }
+
+    private:
+        // invoke a method returning a value
+        template <
+            typename ...Values
+        >
+        static
+        void
+        respond(
+            std::false_type,
+            Accessor const& accessor,
+            object_type& obj,
+            std::vector<byte>& response,
+            Values&&... values
+        ) {
+            encoding::codec<typename std::decay<result_type>::type>::encode(
+                response,
+                accessor.invoke(obj, std::forward<Values>(values)...)
+            );
+        }
+
+        // invoke a method returning nothing
+        template <
+            typename ...Values
+        >
+        static
+        void
+        respond(
+            std::true_type,
+            Accessor const& accessor,
+            object_type& obj,
+            std::vector<byte>&,
+            Values&&... values
+        ) {
+            accessor.invoke(obj, std::forward<Values>(values)...);
+        }
+    };
+
+
+    /**
+     * Handle a call of the method with a specific index
+     */
+    template <
+        std::size_t id ///< index of the method
+    >
+    static
+    bool
+    call(
+        Bundle const& bundle,
+        object_type& obj,
+        byte const*& pos,
+        byte const* end,
+        std::vector<byte>& response
+    ) {
+        typedef typename Bundle::template method_accessor<id> accessor;
+
+        return invoker<accessor, typename accessor::property::arguments>::call(
+            bundle.template method_at<id>(),
+            obj,
+            pos,
+            end,
+            response
+        );
+    }
+
+    /**
+     * Get the table of handlers, indexed by the methods' indices
+     */
+    template <
+        std::size_t ...ids
+    >
+    static
+    handler const*
+    table(
+        std::index_sequence<ids...>
+    ) noexcept {
+        static constexpr handler handlers[] = {&call<ids>...};
+        return handlers;
+    }
+
+
+    Bundle const& _bundle;
+};
+
+
+// definition of the static member, required if it is odr-used
+template <
+    typename Bundle
+>
+constexpr std::size_t dispatcher<Bundle>::size;
+
+
+/**
+ * Create a dispatcher for the methods of an accessor bundle
+ *
+ * \returns a dispatcher invoking the methods of the bundle supplied
+ */
+template <
+    typename Bundle ///< accessor bundle providing the methods
+>
+dispatcher<Bundle>
+make_dispatcher(
+    Bundle const& bundle ///< accessor bundle providing the methods
+) {
+    return dispatcher<Bundle>(bundle);
+}
+
+
+}
+
+
+#endif
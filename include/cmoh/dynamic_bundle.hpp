@@ -0,0 +1,581 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_DYNAMIC_BUNDLE_HPP__
+#define CMOH_DYNAMIC_BUNDLE_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// local includes
+#include <cmoh/accessors/utils.hpp>
+#include <cmoh/encoding.hpp>
+#include <cmoh/optional.hpp>
+#include <cmoh/properties.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Token identifying a type at run time without RTTI
+ */
+typedef void const* type_tag;
+
+
+/**
+ * Get the token identifying a specific type
+ *
+ * The token is the address of a static variable. The variable is not const,
+ * since the linker may fold identical constants, e.g. with identical code
+ * folding or `-fmerge-all-constants`. With GCC and Clang, the function has
+ * default visibility, so the variable is shared by all modules even if they
+ * are built with hidden visibility. Nevertheless, modules loaded with
+ * `RTLD_LOCAL` may end up with distinct tokens for the same type.
+ *
+ * \returns a token unique to the type `Type`
+ */
+template <
+    typename Type ///< type to identify
+>
+#if defined(__GNUC__)
+__attribute__((visibility("default")))
+#endif
+type_tag
+tag_of() noexcept {
+    static char tag;
+    return &tag;
+}
+
+
+/**
+ * Type-erased accessor bundle
+ *
+ * A dynamic bundle exposes the attributes of an `accessor_bundle` to code which
+ * does not know the bundle's type, e.g. a plugin host. Objects and values are
+ * passed as untyped pointers and checked against type tags at run time.
+ *
+ * Attributes are identified by a dense id, which is their index in the order of
+ * the bundle's attribute accessors. For each attribute, the dynamic bundle holds
+ * an entry in a single contiguous table. Each entry holds the attribute's key,
+ * a tag for its type, a pointer to the accessor and plain function pointers for
+ * getting, setting, serializing and deserializing the attribute. Hence, each
+ * operation is dispatched via a single indirect call. Function pointers which
+ * are not applicable to an attribute, e.g. `set` for constant attributes, are
+ * null. Like with the bundle, setting or deserializing an attribute
+ * invalidates the values cached by accessors depending on it, e.g. memoized
+ * attributes. The invalidation is skipped if the bundle has no such accessors.
+ *
+ * The dynamic bundle refers to the accessors of the bundle it was created
+ * from. Hence, the latter has to outlive the former. Users are discouraged from
+ * constructing dynamic bundles directly. Use `make_dynamic()` instead.
+ */
+template <
+    typename KeyType ///< key type used for addressing attributes
+>
+class dynamic_bundle {
+public:
+    typedef typename std::remove_cv<
+        typename std::remove_reference<KeyType>::type
+    >::type key_type;
+    typedef encoding::byte byte;
+
+
+    /// Function storing an attribute's value of an object in an `optional`
+    typedef void (*get_function)(void const* accessor, void const* obj, void* value);
+    /// Function setting an attribute to a value, moving from the value
+    typedef void (*set_function)(void const* accessor, void* obj, void* value);
+    /// Function appending the encoded value of an attribute to a buffer
+    typedef void (*serialize_function)(
+        void const* accessor,
+        void const* obj,
+        std::vector<byte>& buffer
+    );
+    /// Function decoding a value and setting an attribute to it
+    typedef bool (*deserialize_function)(
+        void const* accessor,
+        void* obj,
+        byte const*& pos,
+        byte const* end
+    );
+    /// Function invalidating values cached which depend on an attribute
+    typedef void (*invalidate_function)(
+        void const* bundle,
+        void const* obj,
+        key_type const& key
+    );
+
+
+    /**
+     * Table entry describing a single attribute
+     */
+    struct entry {
+        key_type key; ///< key of the attribute
+        type_tag type; ///< type of the attribute's values
+        void const* accessor; ///< accessor passed to the functions below
+        get_function get;
+        set_function set;
+        serialize_function serialize;
+        deserialize_function deserialize;
+    };
+
+
+    template <
+        typename Bundle ///< type of the bundle to erase
+    >
+    explicit dynamic_bundle(Bundle const& bundle) :
+            _object_type(tag_of<typename Bundle::object_type>()),
+            _bundle(&bundle),
+            _invalidate(invalidate_thunk_if<Bundle>(
+                typename Bundle::has_dependents()
+            )) {
+        bundle.visit_properties([this] (auto const& accessor) {
+            add(accessor, cmoh::accessors::is_attribute_accessor<
+                typename std::decay<decltype(accessor)>::type
+            >());
+        });
+    }
+    dynamic_bundle(dynamic_bundle const&) = default;
+    dynamic_bundle(dynamic_bundle&&) = default;
+
+    dynamic_bundle& operator=(dynamic_bundle const&) = default;
+    dynamic_bundle& operator=(dynamic_bundle&&) = default;
+
+
+    /**
+     * Get the tag of the type of objects accessed
+     */
+    type_tag
+    object_type() const noexcept {
+        return _object_type;
+    }
+
+    /**
+     * Get the number of attributes
+     */
+    std::size_t
+    size() const noexcept {
+        return _table.size();
+    }
+
+    /**
+     * Get the table entry for the attribute with a specific id
+     */
+    entry const&
+    operator [] (
+        std::size_t id ///< id of the attribute
+    ) const noexcept {
+        return _table[id];
+    }
+
+    entry const* begin() const noexcept { return _table.data(); }
+    entry const* end() const noexcept { return _table.data() + _table.size(); }
+
+
+    /**
+     * Look up the id of an attribute by its key
+     *
+     * \returns the id of the attribute or `size()`, if there is no attribute
+     *          with the key supplied
+     */
+    std::size_t
+    id_of(
+        key_type const& key ///< key of the attribute
+    ) const noexcept {
+        std::size_t id = 0;
+        while ((id < _table.size()) && !(_table[id].key == key))
+            ++id;
+        return id;
+    }
+
+
+    /**
+     * Get the value of an attribute
+     *
+     * \returns an optional holding the value or an empty optional, if `Type`
+     *          is not the type of the attribute or there is no attribute
+     *          with the id supplied
+     */
+    template <
+        typename Type ///< type of the attribute
+    >
+    optional<Type>
+    get(
+        void const* obj, ///< object from which to get the value
+        std::size_t id ///< id of the attribute
+    ) const {
+        optional<Type> retval;
+        if (id >= _table.size())
+            return retval;
+        auto const& e = _table[id];
+        if (e.type == tag_of<Type>())
+            e.get(e.accessor, obj, &retval);
+        return retval;
+    }
+
+    /**
+     * Set the value of an attribute
+     *
+     * \returns true if the value was set, false if `Type` is not the type of
+     *          the attribute, if the attribute cannot be set or if there is
+     *          no attribute with the id supplied
+     */
+    template <
+        typename Type ///< type of the attribute
+    >
+    bool
+    set(
+        void* obj, ///< object on which to set the value
+        std::size_t id, ///< id of the attribute
+        Type value ///< value to set
+    ) const {
+        if (id >= _table.size())
+            return false;
+        auto const& e = _table[id];
+        if ((e.type != tag_of<Type>()) || !e.set)
+            return false;
+        e.set(e.accessor, obj, &value);
+        invalidate(obj, e.key);
+        return true;
+    }
+
+    /**
+     * Append the encoded value of an attribute to a buffer
+     *
+     * Values are encoded using `cmoh::encoding::codec`.
+     *
+     * \returns true if the value was encoded, false if no encoding is
+     *          available for the attribute's type or if there is no attribute
+     *          with the id supplied
+     */
+    bool
+    serialize(
+        void const* obj, ///< object from which to get the value
+        std::size_t id, ///< id of the attribute
+        std::vector<byte>& buffer ///< buffer to which to append the value
+    ) const {
+        if (id >= _table.size())
+            return false;
+        auto const& e = _table[id];
+        if (!e.serialize)
+            return false;
+        e.serialize(e.accessor, obj, buffer);
+        return true;
+    }
+
+    /**
+     * Decode a value and set an attribute
+     *
+     * On success, `pos` is advanced past the encoded value.
+     *
+     * \returns true if the value was decoded and set, false otherwise
+     */
+    bool
+    deserialize(
+        void* obj, ///< object on which to set the value
+        std::size_t id, ///< id of the attribute
+        byte const*& pos, ///< position from which to read
+        byte const* end ///< end of the buffer
+    ) const {
+        if (id >= _table.size())
+            return false;
+        auto const& e = _table[id];
+        if (!e.deserialize || !e.deserialize(e.accessor, obj, pos, end))
+            return false;
+        invalidate(obj, e.key);
+        return true;
+    }
+
+
+private:
+    template <
+        typename Accessor
+    >
+    using value_of = typename std::remove_cv<
+        typename properties::type_of_attribute<typename Accessor::property>::type
+    >::type;
+
+
+    template <
+        typename Accessor
+    >
+    static
+    void
+    get_thunk(
+        void const* accessor,
+        void const* obj,
+        void* value
+    ) {
+        *static_cast<optional<value_of<Accessor>>*>(value) =
+            static_cast<Accessor const*>(accessor)->get(
+                *static_cast<typename Accessor::object_type const*>(obj)
+            );
+    }
+
+    // invalidate cached values depending on an attribute, if there are any
+    void
+    invalidate(
+        void const* obj,
+        key_type const& key
+    ) const {
+        if (_invalidate)
+            _invalidate(_bundle, obj, key);
+    }
+
+    template <
+        typename Bundle
+    >
+    static
+    void
+    invalidate_thunk(
+        void const* bundle,
+        void const* obj,
+        key_type const& key
+    ) {
+        static_cast<Bundle const*>(bundle)->invalidate(
+            *static_cast<typename Bundle::object_type const*>(obj),
+            key
+        );
+    }
+
+    template <
+        typename Bundle
+    >
+    static
+    invalidate_function
+    invalidate_thunk_if(
+        std::true_type
+    ) noexcept {
+        return &invalidate_thunk<Bundle>;
+    }
+
+    template <
+        typename Bundle
+    >
+    static
+    invalidate_function
+    invalidate_thunk_if(
+        std::false_type
+    ) noexcept {
+        return nullptr;
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    void
+    set_thunk(
+        void const* accessor,
+        void* obj,
+        void* value
+    ) {
+        static_cast<Accessor const*>(accessor)->set(
+            *static_cast<typename Accessor::object_type*>(obj),
+            std::move(*static_cast<value_of<Accessor>*>(value))
+        );
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    void
+    serialize_thunk(
+        void const* accessor,
+        void const* obj,
+        std::vector<byte>& buffer
+    ) {
+        encoding::codec<value_of<Accessor>>::encode(
+            buffer,
+            static_cast<Accessor const*>(accessor)->get(
+                *static_cast<typename Accessor::object_type const*>(obj)
+            )
+        );
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    bool
+    deserialize_thunk(
+        void const* accessor,
+        void* obj,
+        byte const*& pos,
+        byte const* end
+    ) {
+        value_of<Accessor> value;
+        if (!encoding::codec<value_of<Accessor>>::decode(pos, end, value))
+            return false;
+        static_cast<Accessor const*>(accessor)->set(
+            *static_cast<typename Accessor::object_type*>(obj),
+            std::move(value)
+        );
+        return true;
+    }
+
+
+    // thunks for attributes for which an operation is applicable, or null
+    template <
+        typename Accessor
+    >
+    static
+    set_function
+    set_thunk_if(
+        std::true_type
+    ) noexcept {
+        return &set_thunk<Accessor>;
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    set_function
+    set_thunk_if(
+        std::false_type
+    ) noexcept {
+        return nullptr;
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    serialize_function
+    serialize_thunk_if(
+        std::true_type
+    ) noexcept {
+        return &serialize_thunk<Accessor>;
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    serialize_function
+    serialize_thunk_if(
+        std::false_type
+    ) noexcept {
+        return nullptr;
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    deserialize_function
+    deserialize_thunk_if(
+        std::true_type
+    ) noexcept {
+        return &deserialize_thunk<Accessor>;
+    }
+
+    template <
+        typename Accessor
+    >
+    static
+    deserialize_function
+    deserialize_thunk_if(
+        std::false_type
+    ) noexcept {
+        return nullptr;
+    }
+
+
+    template <
+        typename Accessor
+    >
+    void
+    add(
+        Accessor const& accessor,
+        std::true_type
+    ) {
+        typedef std::integral_constant<
+            bool,
+            cmoh::accessors::is_settable<Accessor>::value
+        > settable;
+        typedef std::integral_constant<
+            bool,
+            encoding::is_encodable<value_of<Accessor>>::value
+        > encodable;
+        typedef std::integral_constant<
+            bool,
+            settable::value && encodable::value &&
+            std::is_default_constructible<value_of<Accessor>>::value
+        > decodable;
+
+        _table.push_back(entry{
+            cmoh::accessors::key(accessor),
+            tag_of<value_of<Accessor>>(),
+            &accessor,
+            &get_thunk<Accessor>,
+            set_thunk_if<Accessor>(settable()),
+            serialize_thunk_if<Accessor>(encodable()),
+            deserialize_thunk_if<Accessor>(decodable())
+        });
+    }
+
+    // overload for accessors which are not attribute accessors
+    template <
+        typename Accessor
+    >
+    void
+    add(
+        Accessor const&,
+        std::false_type
+    ) {}
+
+
+    type_tag _object_type;
+    void const* _bundle;
+    invalidate_function _invalidate;
+    std::vector<entry> _table;
+};
+
+
+/**
+ * Create a dynamic bundle from an accessor bundle
+ *
+ * \returns a dynamic bundle referring to the accessors of the bundle supplied
+ */
+template <
+    typename Bundle ///< type of the bundle to erase
+>
+dynamic_bundle<typename Bundle::key_type>
+make_dynamic(
+    Bundle const& bundle ///< bundle to erase
+) {
+    return dynamic_bundle<typename Bundle::key_type>(bundle);
+}
+
+
+}
+
+
+#endif
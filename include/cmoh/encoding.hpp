@@ -0,0 +1,437 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_ENCODING_HPP__
+#define CMOH_ENCODING_HPP__
+
+
+// std includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace cmoh {
+namespace encoding {
+
+
+typedef unsigned char byte;
+
+
+/**
+ * Append an unsigned integer to a buffer using a variable length encoding
+ *
+ * Integers are encoded in groups of seven bits, least significant group first.
+ * The most significant bit of each byte is set if more bytes follow. Small
+ * values hence occupy a single byte.
+ */
+inline
+void
+write_varint(
+    std::vector<byte>& buffer, ///< buffer to which to append the value
+    std::uint64_t value ///< value to encode
+) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<byte>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<byte>(value));
+}
+
+
+/**
+ * Read an unsigned integer encoded by `write_varint()`
+ *
+ * On success, `pos` is advanced past the encoded value. Encodings of values
+ * which exceed 64 bits are rejected.
+ *
+ * \returns true if a value could be decoded, false otherwise
+ */
+inline
+bool
+read_varint(
+    byte const*& pos, ///< position from which to read
+    byte const* end, ///< end of the buffer
+    std::uint64_t& value ///< decoded value
+) {
+    std::uint64_t retval = 0;
+    for (auto current = pos; (current != end) && (current - pos < 10);
+            ++current) {
+        auto const index = current - pos;
+
+        // the tenth byte may only hold the most significant bit
+        if ((index == 9) && (*current > 1))
+            return false;
+        retval |= static_cast<std::uint64_t>(*current & 0x7f) << (7*index);
+        if (!(*current & 0x80)) {
+            pos = current + 1;
+            value = retval;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Binary encoding of values
+ *
+ * Instantiations provide the static methods
+ *
+ *     static void encode(std::vector<byte>& buffer, Value const& value);
+ *     static bool decode(byte const*& pos, byte const* end, Value& value);
+ *
+ * The former appends the encoding of a value to a buffer, the latter decodes a
+ * value, advancing `pos` past the encoded value. `decode()` returns `false` if
+ * the input is malformed.
+ *
+ * Integral values are encoded as varints, with signed values being zigzag
+ * encoded first. Decoding a value which does not fit the type fails. Booleans
+ * are encoded as a single byte, which must be either zero or one. Enumerations
+ * are encoded like their underlying type and `std::chrono` types via their
+ * count. Strings are encoded as their length, followed by the characters.
+ * Other values have to be trivially copyable and are copied verbatim. Note
+ * that the latter is only portable between hosts with the same representation
+ * of the type.
+ *
+ * Users may specialize this template for their own types.
+ */
+template <
+    typename Value, ///< type of the values to encode
+    typename = void
+>
+struct codec {
+    /**
+     * Marker for detecting the primary template via `is_encodable`
+     */
+    typedef void verbatim;
+
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        Value const& value
+    ) {
+        static_assert(
+            std::is_trivially_copyable<Value>::value,
+            "No encoding available for type"
+        );
+        auto const data = reinterpret_cast<byte const*>(&value);
+        buffer.insert(buffer.end(), data, data + sizeof(Value));
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        Value& value
+    ) {
+        static_assert(
+            std::is_trivially_copyable<Value>::value,
+            "No encoding available for type"
+        );
+        if (static_cast<std::size_t>(end - pos) < sizeof(Value))
+            return false;
+        std::memcpy(&value, pos, sizeof(Value));
+        pos += sizeof(Value);
+        return true;
+    }
+};
+
+// Specialization for unsigned integral types
+template <
+    typename Value
+>
+struct codec<
+    Value,
+    typename std::enable_if<
+        std::is_integral<Value>::value && std::is_unsigned<Value>::value &&
+        !std::is_same<Value, bool>::value
+    >::type
+> {
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        Value value
+    ) {
+        write_varint(buffer, value);
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        Value& value
+    ) {
+        std::uint64_t raw;
+        if (!read_varint(pos, end, raw))
+            return false;
+        if (raw > std::numeric_limits<Value>::max())
+            return false;
+        value = static_cast<Value>(raw);
+        return true;
+    }
+};
+
+// Specialization for signed integral types
+template <
+    typename Value
+>
+struct codec<
+    Value,
+    typename std::enable_if<
+        std::is_integral<Value>::value && std::is_signed<Value>::value
+    >::type
+> {
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        Value value
+    ) {
+        // zigzag encoding maps values of small magnitude to small values
+        auto const wide = static_cast<std::int64_t>(value);
+        write_varint(
+            buffer,
+            (static_cast<std::uint64_t>(wide) << 1) ^
+                static_cast<std::uint64_t>(wide >> 63)
+        );
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        Value& value
+    ) {
+        std::uint64_t raw;
+        if (!read_varint(pos, end, raw))
+            return false;
+        auto const wide = static_cast<std::int64_t>(raw >> 1) ^
+            -static_cast<std::int64_t>(raw & 1);
+        if ((wide < std::numeric_limits<Value>::min()) ||
+            (wide > std::numeric_limits<Value>::max()))
+            return false;
+        value = static_cast<Value>(wide);
+        return true;
+    }
+};
+
+// Specialization for booleans
+template <>
+struct codec<bool> {
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        bool value
+    ) {
+        buffer.push_back(value ? 1 : 0);
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        bool& value
+    ) {
+        // any other byte would not be a valid representation of a bool
+        if ((pos == end) || (*pos > 1))
+            return false;
+        value = *pos++ == 1;
+        return true;
+    }
+};
+
+// Specialization for enumerations
+template <
+    typename Value
+>
+struct codec<Value, typename std::enable_if<std::is_enum<Value>::value>::type> {
+    typedef typename std::underlying_type<Value>::type underlying;
+
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        Value value
+    ) {
+        codec<underlying>::encode(buffer, static_cast<underlying>(value));
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        Value& value
+    ) {
+        underlying raw;
+        if (!codec<underlying>::decode(pos, end, raw))
+            return false;
+        value = static_cast<Value>(raw);
+        return true;
+    }
+};
+
+// Specialization for durations
+template <
+    typename Rep,
+    typename Period
+>
+struct codec<std::chrono::duration<Rep, Period>> {
+    typedef std::chrono::duration<Rep, Period> value_type;
+
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        value_type const& value
+    ) {
+        codec<Rep>::encode(buffer, value.count());
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        value_type& value
+    ) {
+        Rep raw;
+        if (!codec<Rep>::decode(pos, end, raw))
+            return false;
+        value = value_type(raw);
+        return true;
+    }
+};
+
+// Specialization for time points
+template <
+    typename Clock,
+    typename Duration
+>
+struct codec<std::chrono::time_point<Clock, Duration>> {
+    typedef std::chrono::time_point<Clock, Duration> value_type;
+
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        value_type const& value
+    ) {
+        codec<Duration>::encode(buffer, value.time_since_epoch());
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        value_type& value
+    ) {
+        Duration raw;
+        if (!codec<Duration>::decode(pos, end, raw))
+            return false;
+        value = value_type(raw);
+        return true;
+    }
+};
+
+// Specialization for strings
+template <
+    typename CharT,
+    typename Traits,
+    typename Allocator
+>
+struct codec<std::basic_string<CharT, Traits, Allocator>> {
+    typedef std::basic_string<CharT, Traits, Allocator> value_type;
+
+    static
+    void
+    encode(
+        std::vector<byte>& buffer,
+        value_type const& value
+    ) {
+        write_varint(buffer, value.size());
+        auto const data = reinterpret_cast<byte const*>(value.data());
+        buffer.insert(buffer.end(), data, data + value.size()*sizeof(CharT));
+    }
+
+    static
+    bool
+    decode(
+        byte const*& pos,
+        byte const* end,
+        value_type& value
+    ) {
+        std::uint64_t size;
+        auto current = pos;
+        if (!read_varint(current, end, size))
+            return false;
+        if (static_cast<std::uint64_t>(end - current)/sizeof(CharT) < size)
+            return false;
+
+        value.resize(static_cast<std::size_t>(size));
+        std::memcpy(&value[0], current, value.size()*sizeof(CharT));
+        pos = current + value.size()*sizeof(CharT);
+        return true;
+    }
+};
+
+
+/**
+ * Check whether values of a type can be encoded via `codec`
+ *
+ * Provides the member `value`, which is true if `codec` is specialized for the
+ * type or if the type is trivially copyable and false otherwise.
+ */
+template <
+    typename Value, ///< type to check
+    typename = void
+>
+struct is_encodable : std::true_type {};
+
+// Specialization for types handled by the primary template
+template <
+    typename Value
+>
+struct is_encodable<Value, typename codec<Value>::verbatim> :
+    std::is_trivially_copyable<Value> {};
+
+
+}
+}
+
+
+#endif
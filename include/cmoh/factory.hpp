@@ -27,6 +27,7 @@
 
 // local includes
 #include <cmoh/accessors/factory/constructor.hpp>
+#include <cmoh/accessors/factory/with_cost.hpp>
 
 
 #endif
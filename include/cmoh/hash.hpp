@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_HASH_HPP__
+#define CMOH_HASH_HPP__
+
+
+// std includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// local includes
+#include <cmoh/string_view.hpp>
+
+
+namespace cmoh {
+namespace hashing {
+
+
+/**
+ * Mix a hash value into a seed
+ *
+ * The mixer is the finalizer of the splitmix64 generator. It is cheap to
+ * compute, but every bit of the input affects every bit of the output.
+ *
+ * \returns the new seed
+ */
+constexpr
+std::uint64_t
+mix(
+    std::uint64_t seed, ///< seed into which to mix the value
+    std::uint64_t value ///< value to mix
+) noexcept {
+    std::uint64_t retval = (seed ^ value) + 0x9e3779b97f4a7c15ull;
+    retval = (retval ^ (retval >> 30)) * 0xbf58476d1ce4e5b9ull;
+    retval = (retval ^ (retval >> 27)) * 0x94d049bb133111ebull;
+    return retval ^ (retval >> 31);
+}
+
+
+/**
+ * Hashing facility used by accessor bundles
+ *
+ * Instantiations provide a static method `combine()`, which mixes the hash of
+ * a value of type `Value` into a seed. By default, the hash is computed using
+ * `std::hash`. Integral types and enumerations are mixed in directly, while
+ * `std::chrono` durations and time points are hashed via their count. String
+ * views are hashed via their characters.
+ *
+ * Users may specialize this template for their own types.
+ */
+template <
+    typename Value, ///< type of the values to hash
+    typename = void
+>
+struct hasher {
+    static
+    std::uint64_t
+    combine(
+        std::uint64_t seed, ///< seed into which to mix the value's hash
+        Value const& value ///< value to hash
+    ) {
+        return mix(seed, std::hash<Value>()(value));
+    }
+};
+
+// Specialization for integral types and enumerations
+template <
+    typename Value
+>
+struct hasher<
+    Value,
+    typename std::enable_if<
+        std::is_integral<Value>::value || std::is_enum<Value>::value
+    >::type
+> {
+    static
+    constexpr
+    std::uint64_t
+    combine(
+        std::uint64_t seed,
+        Value value
+    ) noexcept {
+        return mix(seed, static_cast<std::uint64_t>(value));
+    }
+};
+
+// Specialization for string views, e.g. keys
+template <
+    typename CharT,
+    typename Traits
+>
+struct hasher<basic_string_view<CharT, Traits>> {
+    static
+    std::uint64_t
+    combine(
+        std::uint64_t seed,
+        basic_string_view<CharT, Traits> const& value
+    ) noexcept {
+        // FNV-1a over the characters
+        std::uint64_t retval = 0xcbf29ce484222325ull;
+        for (auto c : value)
+            retval = (retval ^ static_cast<std::uint64_t>(c)) * 0x100000001b3ull;
+        return mix(seed, retval);
+    }
+};
+
+// Specialization for durations
+template <
+    typename Rep,
+    typename Period
+>
+struct hasher<std::chrono::duration<Rep, Period>> {
+    static
+    std::uint64_t
+    combine(
+        std::uint64_t seed,
+        std::chrono::duration<Rep, Period> const& value
+    ) {
+        return hasher<Rep>::combine(seed, value.count());
+    }
+};
+
+// Specialization for time points
+template <
+    typename Clock,
+    typename Duration
+>
+struct hasher<std::chrono::time_point<Clock, Duration>> {
+    static
+    std::uint64_t
+    combine(
+        std::uint64_t seed,
+        std::chrono::time_point<Clock, Duration> const& value
+    ) {
+        return hasher<Duration>::combine(seed, value.time_since_epoch());
+    }
+};
+
+
+}
+}
+
+
+#endif
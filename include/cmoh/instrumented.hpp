@@ -0,0 +1,590 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_INSTRUMENTED_HPP__
+#define CMOH_INSTRUMENTED_HPP__
+
+
+// std includes
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// local includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/optional.hpp>
+#include <cmoh/utils.hpp>
+
+
+namespace cmoh {
+namespace instrumentation {
+
+
+/**
+ * Policy disabling instrumentation
+ *
+ * Instrumented bundles using this policy forward all operations to the bundle
+ * and hold no counters. Hence, instrumentation is compiled out completely.
+ * Snapshots still hold counters for each attribute, which are all zero.
+ */
+struct disabled {
+    enum : bool {enabled = false, timed = false};
+};
+
+
+/**
+ * Policy counting accesses
+ */
+struct counting {
+    enum : bool {enabled = true, timed = false};
+};
+
+
+/**
+ * Policy counting accesses and measuring the time spent in accessors
+ */
+struct timing {
+    enum : bool {enabled = true, timed = true};
+};
+
+
+/**
+ * Policy used by `cmoh::instrument()` unless specified otherwise
+ *
+ * Instrumentation is disabled unless the macro `CMOH_INSTRUMENTATION` is
+ * defined before including this header.
+ */
+#ifdef CMOH_INSTRUMENTATION
+typedef timing default_policy;
+#else
+typedef disabled default_policy;
+#endif
+
+
+/**
+ * Counters associated with a single attribute
+ */
+struct counters {
+    std::uint64_t gets; ///< number of values retrieved
+    std::uint64_t sets; ///< number of values set
+    std::uint64_t nanoseconds; ///< time spent in the accessor, if measured
+};
+
+
+/**
+ * Counters aggregated over all threads
+ */
+template <
+    std::size_t Count ///< number of attributes
+>
+struct statistics {
+    std::array<counters, Count> attributes; ///< counters by attribute index
+    std::uint64_t misses; ///< number of dynamic keys not found
+};
+
+
+/**
+ * Write aggregated counters to a stream
+ *
+ * One line is written per attribute, holding the attribute's index and its
+ * counters as `name=value` pairs separated by spaces, e.g.
+ *
+ *     attribute=0 gets=12 sets=1 ns=340
+ *
+ * A final line holds the number of misses, e.g. `misses=3`.
+ */
+template <
+    std::size_t Count ///< number of attributes
+>
+void
+dump(
+    std::ostream& stream, ///< stream to write to
+    statistics<Count> const& stats ///< counters to write
+) {
+    for (std::size_t i = 0; i < Count; ++i) {
+        auto const& c = stats.attributes[i];
+        stream << "attribute=" << i
+            << " gets=" << c.gets
+            << " sets=" << c.sets
+            << " ns=" << c.nanoseconds << '\n';
+    }
+    stream << "misses=" << stats.misses << '\n';
+}
+
+
+}
+
+
+/**
+ * Accessor bundle counting accesses to attributes
+ *
+ * An instrumented bundle wraps an accessor bundle and provides the same
+ * `get()` and `set()` methods, for both static and dynamic keys. Depending
+ * on the `Policy`, it counts the values retrieved and set for each attribute,
+ * the number of dynamic keys not found and the time spent in the accessors.
+ *
+ * Counters are kept per thread, in blocks padded to a cache line. Each thread
+ * only ever modifies its own block, without any atomic read-modify-write
+ * operation. The counters of all threads are aggregated on demand via
+ * `snapshot()` or `dump()`. Blocks of threads which exited are retained.
+ *
+ * Instrumented bundles hold a reference to the bundle they were created with.
+ * Hence, the bundle has to outlive them. Users are discouraged from
+ * constructing instrumented bundles directly. Use `instrument()` instead.
+ */
+template <
+    typename Bundle, ///< accessor bundle to instrument
+    typename Policy = instrumentation::default_policy ///< instrumentation policy
+>
+class instrumented {
+public:
+    typedef typename Bundle::key_type key_type;
+    typedef typename Bundle::object_type object_type;
+
+    /**
+     * Aggregated counters
+     */
+    typedef instrumentation::statistics<Bundle::attribute_count> statistics;
+
+
+    explicit instrumented(Bundle const& bundle) :
+        _bundle(bundle), _id(next_id()), _blocks(new blocks()) {}
+    instrumented(instrumented const&) = delete;
+    instrumented(instrumented&&) = default;
+
+
+    /**
+     * Get the bundle instrumented
+     */
+    Bundle const&
+    bundle() const noexcept {
+        return _bundle;
+    }
+
+
+    /**
+     * Get the value of a specific attribute from an object
+     *
+     * \returns the value of the attribute
+     */
+    template <
+        key_type key ///< key of attribute to get
+    >
+    typename Bundle::template property_by_key<key>::type
+    get(
+        object_type const& obj ///< object from which to get the value
+    ) const {
+        constexpr auto index = Bundle::template index_of<key>();
+        auto& c = local().attributes[index];
+        increment(c.gets);
+        stopwatch watch(c.nanoseconds);
+        return _bundle.template get<key>(obj);
+    }
+
+    /**
+     * Set the value of a specific attribute on an object
+     */
+    template <
+        key_type key ///< key of attribute to set
+    >
+    void
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        typename Bundle::template property_by_key<key>::type&& value ///< value to set
+    ) const {
+        constexpr auto index = Bundle::template index_of<key>();
+        auto& c = local().attributes[index];
+        increment(c.sets);
+        stopwatch watch(c.nanoseconds);
+        _bundle.template set<key>(
+            obj,
+            std::forward<typename Bundle::template property_by_key<key>::type>(
+                value
+            )
+        );
+    }
+
+
+    /**
+     * Get the value of a specific attribute from an object
+     *
+     * If the attribute is not found, a miss is counted.
+     *
+     * \returns an optional holding the value of the attribute
+     */
+    template <
+        typename Type, ///< type of the attribute to get
+        typename KeyType = key_type ///< key type to use
+    >
+    optional<Type>
+    get(
+        object_type const& obj, ///< object from which to get the value
+        KeyType&& key ///< key of the attribute to get
+    ) const {
+        auto& block = local();
+        auto const index = _bundle.index_of(key);
+        if (index >= Bundle::attribute_count) {
+            increment(block.misses);
+            return optional<Type>();
+        }
+
+        auto& c = block.attributes[index];
+        stopwatch watch(c.nanoseconds);
+        auto retval = _bundle.template get_at<Type>(obj, index);
+        if (retval)
+            increment(c.gets);
+        else
+            increment(block.misses);
+        return retval;
+    }
+
+    /**
+     * Set the value of a specific attribute on an object
+     *
+     * If the attribute is not found, a miss is counted.
+     *
+     * \returns true if the attribute was set, false otherwise
+     */
+    template <
+        typename Type, ///< type of the attribute to set
+        typename KeyType = key_type ///< key type to use
+    >
+    bool
+    set(
+        object_type& obj, ///< object on which to set the attribute
+        KeyType&& key, ///< key of the attribute to set
+        Type&& value ///< value to set
+    ) const {
+        auto& block = local();
+        auto const index = _bundle.index_of(key);
+        if (index >= Bundle::attribute_count) {
+            increment(block.misses);
+            return false;
+        }
+
+        auto& c = block.attributes[index];
+        stopwatch watch(c.nanoseconds);
+        auto const retval = _bundle.template set_at<Type>(
+            obj,
+            index,
+            std::forward<Type>(value)
+        );
+        if (retval)
+            increment(c.sets);
+        else
+            increment(block.misses);
+        return retval;
+    }
+
+
+    /**
+     * Aggregate the counters of all threads
+     *
+     * The counters are read while other threads may modify them. Hence, the
+     * snapshot is not necessarily consistent across attributes.
+     *
+     * \returns the aggregated counters
+     */
+    statistics
+    snapshot() const {
+        statistics retval{};
+
+        std::lock_guard<std::mutex> lock(_blocks->mutex);
+        for (auto const& b : _blocks->items) {
+            for (std::size_t i = 0; i < Bundle::attribute_count; ++i) {
+                auto& c = retval.attributes[i];
+                c.gets += b->attributes[i].gets.load(std::memory_order_relaxed);
+                c.sets += b->attributes[i].sets.load(std::memory_order_relaxed);
+                c.nanoseconds +=
+                    b->attributes[i].nanoseconds.load(std::memory_order_relaxed);
+            }
+            retval.misses += b->misses.load(std::memory_order_relaxed);
+        }
+        return retval;
+    }
+
+    /**
+     * Write the aggregated counters to a stream
+     *
+     * The counters are written via `instrumentation::dump()`.
+     */
+    void
+    dump(
+        std::ostream& stream ///< stream to write to
+    ) const {
+        instrumentation::dump(stream, snapshot());
+    }
+
+
+private:
+    typedef std::atomic<std::uint64_t> counter;
+
+    struct attribute_counters {
+        counter gets{0};
+        counter sets{0};
+        counter nanoseconds{0};
+    };
+
+    /**
+     * Counters of a single thread
+     *
+     * Blocks are padded, so blocks of different threads never share a cache
+     * line.
+     */
+    struct block {
+        char leading_padding[64];
+        std::array<attribute_counters, Bundle::attribute_count> attributes;
+        counter misses{0};
+        char trailing_padding[64];
+    };
+
+    /**
+     * Blocks of all threads which accessed attributes via an instance
+     *
+     * The blocks are held indirectly, so instrumented bundles may be moved.
+     */
+    struct blocks {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<block>> items;
+        std::vector<std::thread::id> threads; ///< thread owning each block
+    };
+
+    /**
+     * Measurement of the time spent in a scope, if enabled by the policy
+     */
+    struct stopwatch {
+        typedef std::chrono::steady_clock clock;
+
+        stopwatch(counter& c) : _counter(c), _start(start()) {}
+
+        ~stopwatch() {
+            if (Policy::timed)
+                increment(_counter, static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        clock::now() - _start
+                    ).count()
+                ));
+        }
+
+    private:
+        static
+        clock::time_point
+        start() noexcept {
+            return Policy::timed ? clock::now() : clock::time_point();
+        }
+
+        counter& _counter;
+        clock::time_point _start;
+    };
+
+
+    /**
+     * Increment a counter owned by the current thread
+     */
+    static
+    void
+    increment(
+        counter& c,
+        std::uint64_t value = 1
+    ) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Get the counters of the current thread
+     */
+    block&
+    local() const {
+        // cache the block of the instance used last by this thread
+        thread_local std::uint64_t cached_id = 0;
+        thread_local block* cached = nullptr;
+        if (cached_id == _id)
+            return *cached;
+
+        std::lock_guard<std::mutex> lock(_blocks->mutex);
+        auto const thread = std::this_thread::get_id();
+        block* retval = nullptr;
+        for (std::size_t i = 0; i < _blocks->threads.size(); ++i)
+            if (_blocks->threads[i] == thread)
+                retval = _blocks->items[i].get();
+        if (!retval) {
+            _blocks->items.emplace_back(new block());
+            _blocks->threads.push_back(thread);
+            retval = _blocks->items.back().get();
+        }
+
+        cached_id = _id;
+        cached = retval;
+        return *retval;
+    }
+
+    /**
+     * Get a process wide unique id for an instance
+     */
+    static
+    std::uint64_t
+    next_id() noexcept {
+        static std::atomic<std::uint64_t> last{0};
+        return ++last;
+    }
+
+
+    Bundle const& _bundle;
+    std::uint64_t _id;
+    std::unique_ptr<blocks> _blocks;
+};
+
+
+// Specialization for disabled instrumentation
+template <
+    typename Bundle
+>
+class instrumented<Bundle, instrumentation::disabled> {
+public:
+    typedef typename Bundle::key_type key_type;
+    typedef typename Bundle::object_type object_type;
+
+    typedef instrumentation::statistics<Bundle::attribute_count> statistics;
+
+
+    explicit instrumented(Bundle const& bundle) : _bundle(bundle) {}
+    instrumented(instrumented const&) = delete;
+    instrumented(instrumented&&) = default;
+
+
+    Bundle const&
+    bundle() const noexcept {
+        return _bundle;
+    }
+
+
+    template <
+        key_type key
+    >
+    typename Bundle::template property_by_key<key>::type
+    get(
+        object_type const& obj
+    ) const {
+        return _bundle.template get<key>(obj);
+    }
+
+    template <
+        key_type key
+    >
+    void
+    set(
+        object_type& obj,
+        typename Bundle::template property_by_key<key>::type&& value
+    ) const {
+        _bundle.template set<key>(
+            obj,
+            std::forward<typename Bundle::template property_by_key<key>::type>(
+                value
+            )
+        );
+    }
+
+    template <
+        typename Type,
+        typename KeyType = key_type
+    >
+    optional<Type>
+    get(
+        object_type const& obj,
+        KeyType&& key
+    ) const {
+        return _bundle.template get<Type>(obj, std::forward<KeyType>(key));
+    }
+
+    template <
+        typename Type,
+        typename KeyType = key_type
+    >
+    bool
+    set(
+        object_type& obj,
+        KeyType&& key,
+        Type&& value
+    ) const {
+        return _bundle.template set<Type>(
+            obj,
+            std::forward<KeyType>(key),
+            std::forward<Type>(value)
+        );
+    }
+
+
+    // all counters are zero
+    statistics
+    snapshot() const noexcept {
+        return statistics{};
+    }
+
+    void
+    dump(
+        std::ostream& stream
+    ) const {
+        instrumentation::dump(stream, snapshot());
+    }
+
+private:
+    Bundle const& _bundle;
+};
+
+
+/**
+ * Instrument an accessor bundle
+ *
+ * Use like:
+ *
+ *     auto const probe = cmoh::instrument<cmoh::instrumentation::counting>(bundle);
+ *
+ * If no policy is given, `instrumentation::default_policy` is used.
+ *
+ * \returns an instrumented bundle forwarding to the bundle supplied
+ */
+template <
+    typename Policy = instrumentation::default_policy, ///< instrumentation policy
+    typename Bundle ///< accessor bundle to instrument
+>
+instrumented<Bundle, Policy>
+instrument(
+    Bundle const& bundle ///< accessor bundle to instrument
+) {
+    return instrumented<Bundle, Policy>(bundle);
+}
+
+
+}
+
+
+#endif
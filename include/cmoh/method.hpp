@@ -0,0 +1,136 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_METHOD_HPP__
+#define CMOH_METHOD_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+// local includes
+#include <cmoh/accessors/method/by_invocable.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Method declaration utility
+ *
+ * Using this template, a programmer may declare methods she wants to make
+ * invocable via the cmoh system. Methods share their key type with attributes.
+ * Use like:
+ *
+ *     enum properties {balance, deposit};
+ *     using balance_attr = cmoh::attribute<properties, balance, const int>;
+ *     using deposit_method = cmoh::method<properties, deposit, void(int)>;
+ *
+ * Like attributes, methods are not bound to a C++ type. They provide the
+ * `accessor()` static method for creating accessors invoking the method on
+ * objects of a specific C++ type. These accessors provide a method
+ *
+ *     result_type invoke(object_type& obj, Args... args) const;
+ */
+template <
+    typename KeyType, ///< type of the key used to identify the method
+    KeyType Key, ///< identifier of the method
+    typename Signature ///< signature of the method
+>
+struct method;
+
+// Specialization for function signatures
+template <
+    typename KeyType,
+    KeyType Key,
+    typename Result,
+    typename ...Args
+>
+struct method<KeyType, Key, Result(Args...)> {
+    typedef KeyType key_type;
+    typedef Result signature(Args...);
+    typedef Result result_type;
+
+    /**
+     * Types of the arguments, held in a tuple
+     */
+    typedef std::tuple<Args...> arguments;
+
+    /**
+     * Number of arguments taken by the method
+     */
+    static constexpr std::size_t arity = sizeof...(Args);
+
+
+    static
+    constexpr
+    typename std::remove_reference<key_type>::type
+    key() {
+        return Key;
+    }
+
+
+    /**
+     * Get an accessor for the method
+     *
+     * This method creates a new accessor using the invocable passed to it,
+     * e.g. a pointer to a member function. That accessor may be used to invoke
+     * the method on objects of the concrete C++ struct or class `ObjType`.
+     */
+    template <
+        typename ObjType, ///< type of the class or struct with the method
+        typename Invocable ///< type of the invocable implementing the method
+    >
+    static
+    constexpr
+    decltype(accessors::method::make_accessor<method, ObjType>(
+        std::declval<Invocable>()
+    ))
+    accessor(
+        Invocable&& invocable
+    ) {
+        return accessors::method::make_accessor<method, ObjType>(
+            std::forward<Invocable>(invocable)
+        );
+    }
+};
+
+
+// definition of the static member, required if it is odr-used
+template <
+    typename KeyType,
+    KeyType Key,
+    typename Result,
+    typename ...Args
+>
+constexpr std::size_t method<KeyType, Key, Result(Args...)>::arity;
+
+
+}
+
+
+#endif
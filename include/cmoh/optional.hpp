@@ -49,98 +49,264 @@ namespace cmoh {
 
 
 // std includes
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 
 namespace cmoh {
+namespace util {
 
 
 /**
- * Predefinition of the C++17 std::optional type
+ * Storage of an optional value
  *
- * This template provides an optional type which is modelled after the
- * std::optional which is part of the C++17 standart proposal. Note that
- * only a subset of the interface is provided.
+ * The value is stored in a union, which is suitably aligned for the value's
+ * type. The storage is trivially destructible if the value's type is.
  *
- * For documentation, refer to the C++17 proposal or your favorite STL
- * documentation site.
+ * Values of trivial types are stored as a plain member instead, which is
+ * value-initialized if the optional is empty. Unlike a union, such a member
+ * allows compilers to keep the optional in registers while it is built, e.g.
+ * when it is captured by reference by an inlined lambda.
  */
 template <
-    class T
+    class T,
+    bool = std::is_trivially_destructible<T>::value,
+    bool = std::is_trivial<T>::value
 >
-class optional {
+class optional_storage {
 public:
-    typedef T value_type;
+    constexpr optional_storage() noexcept : _empty(), _has_data(false) {}
 
+    constexpr optional_storage(T const& value) : _value(value), _has_data(true) {}
 
-    constexpr optional() : _has_data(false) {}
+    constexpr optional_storage(T&& value) :
+        _value(std::move(value)), _has_data(true) {}
 
-    optional(optional const& other) : _has_data(other.has_value()) {
-        if (_has_data)
-            construct(*(other.value_ptr()));
+    ~optional_storage() {
+        destruct();
     }
 
-    optional(optional&& other) : _has_data(other.has_value()) {
+protected:
+    template <
+        typename ...Args
+    >
+    void construct(Args&&... args) {
+        ::new (static_cast<void*>(std::addressof(_value)))
+            T(std::forward<Args>(args)...);
+        _has_data = true;
+    }
+
+    void destruct() noexcept {
         if (_has_data)
-            construct(std::move(*(other.value_ptr())));
+            _value.~T();
+        _has_data = false;
     }
 
-    constexpr optional(value_type const& value) : _has_data(true) {
-        construct(value);
+    union {
+        char _empty;
+        T _value;
+    };
+    bool _has_data;
+};
+
+// Specialization for trivially destructible types
+template <
+    class T
+>
+class optional_storage<T, true, false> {
+public:
+    constexpr optional_storage() noexcept : _empty(), _has_data(false) {}
+
+    constexpr optional_storage(T const& value) : _value(value), _has_data(true) {}
+
+    constexpr optional_storage(T&& value) :
+        _value(std::move(value)), _has_data(true) {}
+
+protected:
+    template <
+        typename ...Args
+    >
+    void construct(Args&&... args) {
+        ::new (static_cast<void*>(std::addressof(_value)))
+            T(std::forward<Args>(args)...);
+        _has_data = true;
     }
 
-    constexpr optional(value_type&& value) : _has_data(true) {
-        construct(std::move(value));
+    void destruct() noexcept {
+        _has_data = false;
     }
 
+    union {
+        char _empty;
+        T _value;
+    };
+    bool _has_data;
+};
 
-    ~optional() {
-        destruct();
+
+// Specialization for trivial types
+template <
+    class T
+>
+class optional_storage<T, true, true> {
+public:
+    constexpr optional_storage() noexcept : _value(), _has_data(false) {}
+
+    constexpr optional_storage(T const& value) : _value(value), _has_data(true) {}
+
+    constexpr optional_storage(T&& value) :
+        _value(std::move(value)), _has_data(true) {}
+
+protected:
+    template <
+        typename ...Args
+    >
+    void construct(Args&&... args) {
+        _value = T(std::forward<Args>(args)...);
+        _has_data = true;
     }
 
+    void destruct() noexcept {
+        _has_data = false;
+    }
 
-    optional& operator=(optional const& other) {
-        destruct();
-        if ((_has_data = other.has_value()))
-            construct(*(other.value_ptr()));
+    T _value;
+    bool _has_data;
+};
 
-        return *this;
+
+/**
+ * Copy and move operations of an optional value
+ *
+ * If the value's type is trivially copyable, all operations are trivial.
+ * Otherwise, assignments assign the value in place if both the source and the
+ * target hold a value.
+ */
+template <
+    class T,
+    bool = std::is_trivially_copyable<T>::value
+>
+class optional_copy : public optional_storage<T> {
+public:
+    using optional_storage<T>::optional_storage;
+
+    optional_copy() = default;
+
+    optional_copy(optional_copy const& other) : optional_storage<T>() {
+        if (other._has_data)
+            this->construct(other._value);
     }
 
-    optional& operator=(optional&& other) {
-        destruct();
-        if ((_has_data = other.has_value()))
-            construct(std::move(*(other.value_ptr())));
+    optional_copy(optional_copy&& other)
+    noexcept(std::is_nothrow_move_constructible<T>::value) :
+            optional_storage<T>() {
+        if (other._has_data)
+            this->construct(std::move(other._value));
+    }
 
+    optional_copy& operator=(optional_copy const& other) {
+        if (this->_has_data && other._has_data)
+            this->_value = other._value;
+        else if (other._has_data)
+            this->construct(other._value);
+        else
+            this->destruct();
         return *this;
     }
 
+    optional_copy& operator=(optional_copy&& other)
+    noexcept(
+        std::is_nothrow_move_constructible<T>::value &&
+        std::is_nothrow_move_assignable<T>::value
+    ) {
+        if (this->_has_data && other._has_data)
+            this->_value = std::move(other._value);
+        else if (other._has_data)
+            this->construct(std::move(other._value));
+        else
+            this->destruct();
+        return *this;
+    }
+};
+
+// Specialization for trivially copyable types
+template <
+    class T
+>
+class optional_copy<T, true> : public optional_storage<T> {
+public:
+    using optional_storage<T>::optional_storage;
+
+    optional_copy() = default;
+};
+
+
+}
+
+
+/**
+ * Predefinition of the C++17 std::optional type
+ *
+ * This template provides an optional type which is modelled after the
+ * std::optional which is part of the C++17 standart proposal. Note that
+ * only a subset of the interface is provided.
+ *
+ * Like the std::optional, an optional of a trivially copyable type is itself
+ * trivially copyable and may thus be passed in registers.
+ *
+ * For documentation, refer to the C++17 proposal or your favorite STL
+ * documentation site.
+ */
+template <
+    class T
+>
+class optional : private util::optional_copy<T> {
+    typedef util::optional_copy<T> base;
+
+public:
+    typedef T value_type;
+
+
+    constexpr optional() = default;
+
+    constexpr optional(value_type const& value) : base(value) {}
+
+    constexpr optional(value_type&& value) : base(std::move(value)) {}
+
+
     template <
-        typename U
+        typename U,
+        typename = typename std::enable_if<
+            !std::is_same<typename std::decay<U>::type, optional>::value
+        >::type
     >
     optional& operator=(U&& value) {
-        destruct();
-        construct(std::forward<U>(value));
-        _has_data = true;
+        if (has_value())
+            this->_value = std::forward<U>(value);
+        else
+            this->construct(std::forward<U>(value));
 
         return *this;
     }
 
 
     constexpr const value_type* operator->() const {
-        return value_ptr();
+        return std::addressof(this->_value);
     }
 
     constexpr value_type* operator->() {
-        return value_ptr();
+        return std::addressof(this->_value);
     }
 
     constexpr value_type const& operator*() const {
-        return *value_ptr();
+        return this->_value;
     }
 
     constexpr value_type& operator*() {
-        return *value_ptr();
+        return this->_value;
     }
 
 
@@ -149,7 +315,7 @@ public:
     }
 
     constexpr bool has_value() const noexcept {
-        return _has_data;
+        return this->_has_data;
     }
 
 
@@ -169,58 +335,28 @@ public:
 
 
     void reset() noexcept {
-        destruct();
-        _has_data = false;
+        this->destruct();
     }
 
 
     template <typename ...Args>
     void emplace(Args&&... args) {
-        destruct();
-        construct(std::forward<Args>(args)...);
-        _has_data = true;
+        this->destruct();
+        this->construct(std::forward<Args>(args)...);
     }
 
     template <typename U, typename ...Args>
-    std::enable_if<
+    typename std::enable_if<
         std::is_constructible<
             value_type,
             std::initializer_list<U>&,
             Args&&...
         >::value
-    >
+    >::type
     emplace(std::initializer_list<U> ilist, Args&&... args) {
-        destruct();
-        construct(ilist, std::forward<Args>(args)...);
-        _has_data = true;
-    }
-
-
-private:
-    template <
-        typename ...Args
-    >
-    void construct(Args&&... args) {
-        new(value_ptr()) value_type(std::forward<Args>(args)...);
-    }
-
-    void destruct() noexcept {
-        if (has_value())
-            value_ptr()->value_type::~value_type();
+        this->destruct();
+        this->construct(ilist, std::forward<Args>(args)...);
     }
-
-
-    constexpr value_type const* value_ptr() const noexcept {
-        return reinterpret_cast<value_type const*>(&_data[0]);
-    }
-
-    constexpr value_type* value_ptr() noexcept {
-        return reinterpret_cast<value_type*>(&_data[0]);
-    }
-
-
-    char _data[sizeof(T)];
-    bool _has_data;
 };
 
 
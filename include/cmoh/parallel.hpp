@@ -0,0 +1,127 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_PARALLEL_HPP__
+#define CMOH_PARALLEL_HPP__
+
+
+// std includes
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+
+namespace cmoh {
+namespace util {
+
+
+/**
+ * Determine the number of threads to use for processing elements in parallel
+ *
+ * Each thread is assigned at least `grain` elements. If `threads` is zero, at
+ * most one thread per hardware thread is used.
+ *
+ * \returns the number of threads to use, which is at least one
+ */
+inline
+std::size_t
+thread_count(
+    std::size_t count, ///< number of elements to process
+    std::size_t grain, ///< minimum number of elements per thread
+    std::size_t threads = 0 ///< maximum number of threads, zero for a default
+) {
+    if (threads == 0)
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<std::size_t>(
+        std::min(threads, count / std::max<std::size_t>(grain, 1)),
+        1
+    );
+}
+
+
+/**
+ * Process a sequence of elements in contiguous parts, in parallel
+ *
+ * The elements are split into `threads` contiguous parts of about the same
+ * size. For each part, `function` is called with the number of the part and
+ * the indices of its first and past-the-end elements. The first part is
+ * processed by the calling thread, the other ones by threads of their own.
+ * If a thread can not be started, its part is processed by the calling
+ * thread instead.
+ *
+ * The function returns after all parts were processed. If `function` throws
+ * an exception, the exception thrown for the part with the lowest number is
+ * rethrown.
+ */
+template <
+    typename Function ///< type of the function to call for each part
+>
+void
+parallel_for(
+    std::size_t count, ///< number of elements
+    std::size_t threads, ///< number of parts, at least one
+    Function const& function ///< function to call for each part
+) {
+    if (threads == 1) {
+        function(0, 0, count);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    auto const run = [&] (std::size_t part) {
+        try {
+            function(part, count*part/threads, count*(part + 1)/threads);
+        } catch (...) {
+            errors[part] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    try {
+        for (std::size_t part = 1; part < threads; ++part)
+            workers.emplace_back(run, part);
+    } catch (std::system_error const&) {
+        // we process the remaining parts ourselves
+    }
+
+    run(0);
+    for (auto part = workers.size() + 1; part < threads; ++part)
+        run(part);
+    for (auto& worker : workers)
+        worker.join();
+
+    for (auto const& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_PATCH_HPP__
+#define CMOH_PATCH_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// local includes
+#include <cmoh/encoding.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Binary patch of an object's attributes
+ *
+ * A patch is a sequence of entries, each consisting of the index of an
+ * attribute and its encoded value. Indices are encoded as varints, values
+ * using `cmoh::encoding::codec`. The encoded patch is exposed via `data()` and
+ * `size()` and may be transmitted as is. A patch can be reconstructed from the
+ * received bytes.
+ *
+ * Patches are produced and applied by accessor bundles via their `diff()` and
+ * `apply()` methods. Indices refer to the settable attributes of the bundle in
+ * the order of their accessors. Hence, a patch can only be applied using the
+ * same bundle type it was created with. Entries appear in ascending order of
+ * their indices.
+ */
+class patch {
+public:
+    typedef encoding::byte byte;
+
+
+    /**
+     * Sequential reader for the entries of a patch
+     */
+    class reader {
+    public:
+        reader(patch const& p) : _pos(p.data()), _end(p.data() + p.size()) {
+            next();
+        }
+
+        /**
+         * Get the index of the attribute the current entry is for
+         *
+         * \returns true if there is a current entry, false otherwise
+         */
+        bool entry(std::size_t& index) const noexcept {
+            index = _index;
+            return _has_entry;
+        }
+
+        /**
+         * Decode the current entry's value and advance to the next entry
+         *
+         * \returns true if the value could be decoded, false otherwise
+         */
+        template <
+            typename Value ///< type of the value to decode
+        >
+        bool read(Value& value) {
+            if (!_has_entry || !encoding::codec<Value>::decode(_pos, _end, value)) {
+                _has_entry = false;
+                _valid = false;
+                return false;
+            }
+            next();
+            return _valid;
+        }
+
+        /**
+         * Check whether all entries were consumed without errors
+         */
+        bool done() const noexcept {
+            return _valid && !_has_entry;
+        }
+
+    private:
+        void next() {
+            _has_entry = false;
+            if (_pos == _end)
+                return;
+
+            std::uint64_t index;
+            if (!encoding::read_varint(_pos, _end, index)) {
+                _valid = false;
+                return;
+            }
+            _index = static_cast<std::size_t>(index);
+            _has_entry = true;
+        }
+
+        byte const* _pos;
+        byte const* _end;
+        std::size_t _index = 0;
+        bool _has_entry = false;
+        bool _valid = true;
+    };
+
+
+    patch() = default;
+    patch(patch const&) = default;
+    patch(patch&&) = default;
+    patch(byte const* data, std::size_t size) : _data(data, data + size) {}
+
+    patch& operator=(patch const&) = default;
+    patch& operator=(patch&&) = default;
+
+
+    /**
+     * Append an entry to the patch
+     *
+     * Entries must be added in ascending order of their indices.
+     */
+    template <
+        typename Value ///< type of the value
+    >
+    void
+    add(
+        std::size_t index, ///< index of the attribute
+        Value const& value ///< new value of the attribute
+    ) {
+        encoding::write_varint(_data, index);
+        encoding::codec<Value>::encode(_data, value);
+    }
+
+
+    byte const* data() const noexcept {
+        return _data.data();
+    }
+
+    std::size_t size() const noexcept {
+        return _data.size();
+    }
+
+    bool empty() const noexcept {
+        return _data.empty();
+    }
+
+
+private:
+    std::vector<byte> _data;
+};
+
+
+}
+
+
+#endif
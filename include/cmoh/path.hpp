@@ -0,0 +1,509 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_PATH_HPP__
+#define CMOH_PATH_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// local includes
+#include <cmoh/accessors/utils.hpp>
+#include <cmoh/optional.hpp>
+#include <cmoh/string_view.hpp>
+
+
+namespace cmoh {
+namespace paths {
+
+
+/**
+ * Convert a segment of a path to a key
+ *
+ * Integral and enumeration keys are parsed as decimal numbers. Numbers which
+ * do not fit the key's type, or the underlying type of an enumeration, are
+ * rejected. Other keys, e.g. string views, are constructed from the segment
+ * directly.
+ *
+ * \returns true if the segment could be converted, false otherwise
+ */
+template <
+    typename KeyType ///< type of the key
+>
+typename std::enable_if<
+    std::is_integral<KeyType>::value || std::is_enum<KeyType>::value,
+    bool
+>::type
+parse_key(
+    string_view segment, ///< segment to convert
+    KeyType& key ///< key to assign
+) {
+    typedef typename std::conditional<
+        std::is_enum<KeyType>::value,
+        std::underlying_type<KeyType>,
+        std::enable_if<true, KeyType>
+    >::type::type integral;
+
+    if (segment.empty())
+        return false;
+
+    auto const limit = static_cast<unsigned long long>(
+        std::numeric_limits<integral>::max()
+    );
+    unsigned long long value = 0;
+    for (std::size_t i = 0; i < segment.size(); ++i) {
+        if ((segment[i] < '0') || (segment[i] > '9'))
+            return false;
+        auto const digit = static_cast<unsigned long long>(segment[i] - '0');
+        if ((digit > limit) || (value > (limit - digit) / 10))
+            return false;
+        value = value * 10 + digit;
+    }
+    key = static_cast<KeyType>(static_cast<integral>(value));
+    return true;
+}
+
+// overload for keys constructible from string views
+template <
+    typename KeyType
+>
+typename std::enable_if<
+    !std::is_integral<KeyType>::value && !std::is_enum<KeyType>::value,
+    bool
+>::type
+parse_key(
+    string_view segment,
+    KeyType& key
+) {
+    key = KeyType(segment);
+    return true;
+}
+
+
+/**
+ * Parser converting segments of paths via `parse_key()`
+ */
+struct default_parser {
+    template <
+        typename KeyType ///< type of the key
+    >
+    bool
+    operator() (
+        string_view segment, ///< segment to convert
+        KeyType& key ///< key to assign
+    ) const {
+        return parse_key(segment, key);
+    }
+};
+
+
+template <
+    typename Bundle,
+    typename Parser
+>
+bool
+resolve(
+    Bundle const& bundle,
+    string_view text,
+    Parser const& parser,
+    char separator,
+    std::vector<std::size_t>& indices
+);
+
+
+// resolve the remainder of a path within a nested object
+template <
+    typename Accessor,
+    typename Parser
+>
+bool
+resolve_nested(
+    Accessor const& accessor,
+    string_view text,
+    Parser const& parser,
+    char separator,
+    std::vector<std::size_t>& indices,
+    std::true_type
+) {
+    return resolve(accessor.bundle(), text, parser, separator, indices);
+}
+
+// overload for attributes not being nested objects
+template <
+    typename Accessor,
+    typename Parser
+>
+bool
+resolve_nested(
+    Accessor const&,
+    string_view,
+    Parser const&,
+    char,
+    std::vector<std::size_t>&,
+    std::false_type
+) {
+    return false;
+}
+
+
+/**
+ * Resolve the keys in a path to attribute indices
+ *
+ * The indices are appended to `indices`.
+ *
+ * \returns true if the path addresses an attribute, false otherwise
+ */
+template <
+    typename Bundle, ///< accessor bundle for the object at which the path starts
+    typename Parser ///< parser converting segments to keys
+>
+bool
+resolve(
+    Bundle const& bundle, ///< accessor bundle for the object
+    string_view text, ///< path to resolve
+    Parser const& parser, ///< parser converting segments to keys
+    char separator, ///< separator between keys
+    std::vector<std::size_t>& indices ///< indices resolved
+) {
+    std::size_t length = 0;
+    while ((length < text.size()) && (text[length] != separator))
+        ++length;
+
+    typename std::decay<typename Bundle::key_type>::type key{};
+    if (!parser(string_view(text.data(), length), key))
+        return false;
+
+    auto const index = bundle.index_of(key);
+    if (index == Bundle::npos)
+        return false;
+    indices.push_back(index);
+
+    if (length == text.size())
+        return true;
+
+    bool retval = false;
+    bundle.visit_attribute_at(index, [&] (auto const& accessor) {
+        retval = resolve_nested(
+            accessor,
+            string_view(text.data() + length + 1, text.size() - length - 1),
+            parser,
+            separator,
+            indices,
+            cmoh::accessors::is_nested<
+                typename std::decay<decltype(accessor)>::type
+            >()
+        );
+    });
+    return retval;
+}
+
+
+}
+
+
+/**
+ * Precompiled path to an attribute of a nested object
+ *
+ * A path is a sequence of attribute indices, as returned by the bundles'
+ * `index_of()`, leading from an object over nested objects to an attribute.
+ * All but the last attribute on the path have to be accessed via accessors for
+ * nested objects, e.g. ones created via `cmoh::nest()`.
+ *
+ * When a path is evaluated, nested objects are accessed via references if
+ * their accessors provide them. Only objects retrieved via accessors not
+ * providing references are copied.
+ *
+ * Paths hold a reference to the bundle they were compiled for. Hence, the
+ * bundle has to outlive them. Users are discouraged from constructing paths
+ * directly. Use `compile_path()` instead.
+ */
+template <
+    typename Bundle ///< accessor bundle for the root object
+>
+class path {
+public:
+    typedef typename Bundle::object_type object_type;
+
+
+    path(Bundle const& bundle, std::vector<std::size_t> indices) :
+        _bundle(&bundle), _indices(std::move(indices)) {}
+    path(path const&) = default;
+    path(path&&) = default;
+    path& operator = (path const&) = default;
+    path& operator = (path&&) = default;
+
+
+    /**
+     * Get the indices of the attributes on the path
+     */
+    std::vector<std::size_t> const&
+    indices() const noexcept {
+        return _indices;
+    }
+
+
+    /**
+     * Call a visitor with the value of the attribute addressed by the path
+     *
+     * The visitor is called with a const reference to the value, which is only
+     * valid during the call.
+     *
+     * \returns true if the visitor was called, false otherwise
+     */
+    template <
+        typename Visitor ///< type of the visitor
+    >
+    bool
+    visit(
+        object_type const& obj, ///< object at which the path starts
+        Visitor&& visitor ///< visitor receiving the value
+    ) const {
+        if (_indices.empty())
+            return false;
+        return walk(
+            *_bundle,
+            obj,
+            _indices.data(),
+            _indices.data() + _indices.size(),
+            visitor
+        );
+    }
+
+    /**
+     * Get the value of the attribute addressed by the path
+     *
+     * If the attribute's type is not convertible to `Type`, the method
+     * behaves as if the attribute does not exist.
+     *
+     * \returns an optional holding the value of the attribute
+     */
+    template <
+        typename Type ///< type of the value to get
+    >
+    optional<Type>
+    get(
+        object_type const& obj ///< object at which the path starts
+    ) const {
+        optional<Type> retval;
+        visit(obj, [&retval] (auto const& value) {
+            assign(retval, value, std::is_convertible<decltype(value), Type>());
+        });
+        return retval;
+    }
+
+
+private:
+    template <
+        typename Type,
+        typename Value
+    >
+    static
+    void
+    assign(
+        optional<Type>& target,
+        Value const& value,
+        std::true_type
+    ) {
+        target = Type(value);
+    }
+
+    template <
+        typename Type,
+        typename Value
+    >
+    static
+    void
+    assign(
+        optional<Type>&,
+        Value const&,
+        std::false_type
+    ) {}
+
+
+    // call a function with a reference to an attribute's value
+    template <
+        typename Accessor,
+        typename Function
+    >
+    static
+    void
+    with_value(
+        Accessor const& accessor,
+        typename Accessor::object_type const& obj,
+        Function&& function,
+        std::true_type
+    ) {
+        function(accessor.ref(obj));
+    }
+
+    // overload for accessors not providing references
+    template <
+        typename Accessor,
+        typename Function
+    >
+    static
+    void
+    with_value(
+        Accessor const& accessor,
+        typename Accessor::object_type const& obj,
+        Function&& function,
+        std::false_type
+    ) {
+        auto const value = accessor.get(obj);
+        function(value);
+    }
+
+
+    // descend into a nested object
+    template <
+        typename Accessor,
+        typename Visitor
+    >
+    static
+    bool
+    descend(
+        Accessor const& accessor,
+        typename Accessor::object_type const& obj,
+        std::size_t const* index,
+        std::size_t const* end,
+        Visitor& visitor,
+        std::true_type
+    ) {
+        bool retval = false;
+        with_value(
+            accessor,
+            obj,
+            [&] (typename Accessor::bundle_type::object_type const& nested) {
+                retval = walk(accessor.bundle(), nested, index, end, visitor);
+            },
+            cmoh::accessors::is_referenceable<Accessor>()
+        );
+        return retval;
+    }
+
+    // overload for attributes not being nested objects
+    template <
+        typename Accessor,
+        typename Visitor
+    >
+    static
+    bool
+    descend(
+        Accessor const&,
+        typename Accessor::object_type const&,
+        std::size_t const*,
+        std::size_t const*,
+        Visitor&,
+        std::false_type
+    ) {
+        return false;
+    }
+
+
+    template <
+        typename B,
+        typename Visitor
+    >
+    static
+    bool
+    walk(
+        B const& bundle,
+        typename B::object_type const& obj,
+        std::size_t const* index,
+        std::size_t const* end,
+        Visitor& visitor
+    ) {
+        bool retval = false;
+        bundle.visit_attribute_at(*index, [&] (auto const& accessor) {
+            typedef typename std::decay<decltype(accessor)>::type accessor_type;
+            if (index + 1 == end) {
+                with_value(
+                    accessor,
+                    obj,
+                    visitor,
+                    cmoh::accessors::is_referenceable<accessor_type>()
+                );
+                retval = true;
+            } else {
+                retval = descend(
+                    accessor,
+                    obj,
+                    index + 1,
+                    end,
+                    visitor,
+                    cmoh::accessors::is_nested<accessor_type>()
+                );
+            }
+        });
+        return retval;
+    }
+
+
+    Bundle const* _bundle;
+    std::vector<std::size_t> _indices;
+};
+
+
+/**
+ * Compile a path given as a string
+ *
+ * The string consists of keys separated by the `separator`, e.g.
+ * `"address.city"`. Each key is converted using the `parser`, which is called
+ * as `parser(segment, key)` with the segment as a `cmoh::string_view` and a
+ * reference to the key to assign. It returns whether the conversion succeeded.
+ * As the key types of nested bundles may differ, the parser has to accept all
+ * of them. By default, `cmoh::paths::parse_key()` is used.
+ *
+ * Each key is resolved to an attribute index once. The path returned may then
+ * be evaluated repeatedly without any further key lookup.
+ *
+ * \returns an optional holding the path or an empty one, if the string does
+ *          not address an attribute
+ */
+template <
+    typename Bundle, ///< accessor bundle for the root object
+    typename Parser = paths::default_parser ///< parser converting segments to keys
+>
+optional<path<Bundle>>
+compile_path(
+    Bundle const& bundle, ///< accessor bundle for the root object
+    string_view text, ///< path to compile
+    Parser const& parser = Parser(), ///< parser converting segments to keys
+    char separator = '.' ///< separator between keys
+) {
+    std::vector<std::size_t> indices;
+    if (!paths::resolve(bundle, text, parser, separator, indices))
+        return optional<path<Bundle>>();
+    return path<Bundle>(bundle, std::move(indices));
+}
+
+}
+
+
+#endif
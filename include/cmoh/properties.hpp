@@ -84,6 +84,29 @@ struct is_attribute_with_type<
 > : std::is_same<typename Property::type, Type> {};
 
 
+/**
+ * Check whether a property is a method
+ *
+ * If the property supplied is a method, e.g. a `cmoh::method`, the static
+ * member `value` will be true. Otherwise, `value` will be false. Methods are
+ * detected via their member `signature`.
+ */
+template <
+    typename Property, ///< property to check
+    typename = void
+>
+struct is_method : std::false_type {};
+
+// Specialization for methods
+template <
+    typename Property
+>
+struct is_method<
+    Property,
+    util::void_t<typename Property::signature>
+> : std::true_type {};
+
+
 }
 }
 
@@ -0,0 +1,548 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_QUERY_HPP__
+#define CMOH_QUERY_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// local includes
+#include <cmoh/parallel.hpp>
+
+
+namespace cmoh {
+namespace query {
+
+
+/**
+ * Executor evaluating a pipeline in parallel
+ *
+ * Passing an executor to an operation terminating a pipeline splits the
+ * sequence into contiguous parts, which are evaluated by threads of their own.
+ * Each thread is assigned at least `grain` objects, hence small sequences are
+ * still evaluated by a single thread.
+ */
+struct parallel {
+    explicit parallel(
+        std::size_t threads = 0, ///< maximum number of threads, zero for one per hardware thread
+        std::size_t grain = 16384 ///< minimum number of objects per thread
+    ) : threads(threads), grain(grain) {}
+
+    std::size_t threads;
+    std::size_t grain;
+};
+
+
+/**
+ * Filter accepting every object
+ *
+ * This is the filter of a pipeline to which no `where()` clause was applied.
+ */
+struct accept_all {
+    template <
+        typename Bundle,
+        typename Object
+    >
+    constexpr
+    bool
+    operator () (
+        Bundle const& bundle,
+        Object const& obj
+    ) const noexcept {
+        return true;
+    }
+};
+
+
+/**
+ * Filter testing the value of an attribute in addition to another filter
+ *
+ * An object passes the filter if it passes the `Previous` filter and the
+ * `Predicate` holds for the value of the attribute identified by `key`. The
+ * `Predicate` is only evaluated if the object passes the `Previous` filter.
+ */
+template <
+    typename Bundle, ///< accessor bundle used for accessing attributes
+    typename Previous, ///< filter to apply before this one
+    typename Bundle::key_type key, ///< key of the attribute to test
+    typename Predicate ///< predicate to test the value with
+>
+struct where_filter {
+    where_filter(Previous previous, Predicate predicate) :
+        _previous(std::move(previous)), _predicate(std::move(predicate)) {}
+
+    bool
+    operator () (
+        Bundle const& bundle, ///< bundle to use for accessing the attribute
+        typename Bundle::object_type const& obj ///< object to test
+    ) const {
+        return _previous(bundle, obj) &&
+            _predicate(bundle.template get<key>(obj));
+    }
+
+private:
+    Previous _previous;
+    Predicate _predicate;
+};
+
+
+/**
+ * Projection passing on the object itself
+ *
+ * This is the projection of a pipeline to which no `select()` was applied.
+ */
+struct identity {
+    template <
+        typename Bundle,
+        typename Object
+    >
+    constexpr
+    Object const&
+    operator () (
+        Bundle const& bundle,
+        Object const& obj
+    ) const noexcept {
+        return obj;
+    }
+};
+
+
+/**
+ * Projection of an object to the values of some of its attributes
+ *
+ * The values of the attributes identified by `keys` are returned as a tuple,
+ * in the order of the keys.
+ */
+template <
+    typename Bundle, ///< accessor bundle used for accessing attributes
+    typename Bundle::key_type ...keys ///< keys of the attributes to select
+>
+struct projection {
+    typedef std::tuple<
+        typename Bundle::template property_by_key<keys>::type...
+    > value_type;
+
+    value_type
+    operator () (
+        Bundle const& bundle, ///< bundle to use for accessing the attributes
+        typename Bundle::object_type const& obj ///< object to project
+    ) const {
+        return value_type(bundle.template get<keys>(obj)...);
+    }
+};
+
+
+/**
+ * Query pipeline over a sequence of objects
+ *
+ * A pipeline consists of a sequence of objects, a filter and a projection.
+ * Pipelines are built from an accessor bundle and a sequence of objects using
+ * `cmoh::from()`. Filter clauses are added using `where()`, a projection may be
+ * set using `select()`:
+ *
+ *     from(accessors, people)
+ *         .where<age>([] (auto value) { return value > limit; })
+ *         .select<first_name, last_name>()
+ *         .for_each([] (auto const& tuple) { ... });
+ *
+ * Filter and projection are composed at compile time, and every operation
+ * terminating a pipeline, e.g. `for_each()` or `group_by()`, evaluates them in
+ * a single pass over the sequence without any intermediate containers.
+ *
+ * Pipelines hold a reference to the bundle they were created with. Hence, the
+ * bundle has to outlive the pipeline.
+ *
+ * Operations may also be evaluated in parallel by passing a `parallel`
+ * executor. The filter and projection are then evaluated concurrently, for
+ * distinct objects.
+ */
+template <
+    typename Bundle, ///< accessor bundle used for accessing attributes
+    typename Iterator, ///< type of iterator into the sequence of objects
+    typename Filter = accept_all, ///< filter to apply
+    typename Projection = identity ///< projection to apply
+>
+struct pipeline {
+    typedef typename Bundle::key_type key_type;
+    typedef typename Bundle::object_type object_type;
+
+
+    pipeline(
+        Bundle const& bundle,
+        Iterator first,
+        Iterator last,
+        Filter filter = Filter(),
+        Projection projection = Projection()
+    ) : _bundle(bundle),
+        _first(std::move(first)),
+        _last(std::move(last)),
+        _filter(std::move(filter)),
+        _projection(std::move(projection)) {}
+    pipeline(pipeline const&) = default;
+    pipeline(pipeline&&) = default;
+
+
+    /**
+     * Add a filter clause on an attribute
+     *
+     * Only objects for which the `predicate` holds for the value of the
+     * attribute identified by `key` will be considered. Clauses added by
+     * consecutive calls are combined using a (short-circuiting) conjunction.
+     *
+     * \returns a new pipeline with the clause added
+     */
+    template <
+        key_type key, ///< key of the attribute to test
+        typename Predicate ///< type of the predicate
+    >
+    pipeline<Bundle, Iterator, where_filter<Bundle, Filter, key, Predicate>, Projection>
+    where(
+        Predicate predicate ///< predicate to test the value of the attribute
+    ) const {
+        return {
+            _bundle,
+            _first,
+            _last,
+            where_filter<Bundle, Filter, key, Predicate>(
+                _filter,
+                std::move(predicate)
+            ),
+            _projection
+        };
+    }
+
+    /**
+     * Select attributes to pass on instead of the objects
+     *
+     * Operations terminating the pipeline will be passed tuples of the
+     * attributes' values instead of the objects.
+     *
+     * \returns a new pipeline with the projection set
+     */
+    template <
+        key_type ...keys ///< keys of the attributes to select
+    >
+    pipeline<Bundle, Iterator, Filter, projection<Bundle, keys...>>
+    select() const {
+        return {_bundle, _first, _last, _filter, projection<Bundle, keys...>()};
+    }
+
+
+    /**
+     * Call a function for each object passing the filter
+     *
+     * The function is called with the projection of each object.
+     */
+    template <
+        typename Function ///< type of the function to call
+    >
+    void
+    for_each(
+        Function&& function ///< function to call
+    ) const {
+        for_each(_first, _last, function);
+    }
+
+    /**
+     * Call a function for each object passing the filter, in parallel
+     *
+     * The function is called concurrently by multiple threads. Hence, it has
+     * to be safe to call concurrently.
+     */
+    template <
+        typename Function ///< type of the function to call
+    >
+    void
+    for_each(
+        Function&& function, ///< function to call
+        parallel const& executor ///< executor to use
+    ) const {
+        evaluate(threads(executor), [&] (
+            std::size_t,
+            Iterator first,
+            Iterator last
+        ) {
+            for_each(first, last, function);
+        });
+    }
+
+    /**
+     * Count the objects passing the filter
+     *
+     * \returns the number of objects passing the filter
+     */
+    std::size_t
+    count() const {
+        return count(_first, _last);
+    }
+
+    /**
+     * Count the objects passing the filter, in parallel
+     *
+     * \returns the number of objects passing the filter
+     */
+    std::size_t
+    count(
+        parallel const& executor ///< executor to use
+    ) const {
+        std::vector<std::size_t> counts(threads(executor));
+        evaluate(counts.size(), [&] (
+            std::size_t part,
+            Iterator first,
+            Iterator last
+        ) {
+            counts[part] = count(first, last);
+        });
+
+        std::size_t retval = 0;
+        for (auto part_count : counts)
+            retval += part_count;
+        return retval;
+    }
+
+    /**
+     * Aggregate objects passing the filter in groups
+     *
+     * The objects are grouped by the value of the attribute identified by
+     * `key`. Each group has an accumulator, which is initialized with a copy
+     * of `init`. For each object, the `fold` function is called with the
+     * group's accumulator and the projection of the object.
+     *
+     * \returns a map from each attribute value to the group's accumulator
+     */
+    template <
+        key_type key, ///< key of the attribute by which to group
+        typename Accumulator, ///< type of the accumulators
+        typename Function ///< type of the function folding the values
+    >
+    std::map<typename Bundle::template property_by_key<key>::type, Accumulator>
+    group_by(
+        Accumulator const& init, ///< initial value of each accumulator
+        Function&& fold ///< function folding a value into an accumulator
+    ) const {
+        std::map<
+            typename Bundle::template property_by_key<key>::type,
+            Accumulator
+        > retval;
+        group_by<key>(_first, _last, retval, init, fold);
+        return retval;
+    }
+
+    /**
+     * Aggregate objects passing the filter in groups, in parallel
+     *
+     * Each thread aggregates a contiguous part of the sequence into groups of
+     * its own, using `fold` like the sequential `group_by()`. Afterwards, the
+     * accumulators of the parts are combined in the order of the parts: for
+     * each group found in more than one part, `merge` is called with the
+     * group's accumulator so far and the accumulator of the next part.
+     *
+     * \returns a map from each attribute value to the group's accumulator
+     */
+    template <
+        key_type key, ///< key of the attribute by which to group
+        typename Accumulator, ///< type of the accumulators
+        typename Function, ///< type of the function folding the values
+        typename Merge ///< type of the function merging accumulators
+    >
+    std::map<typename Bundle::template property_by_key<key>::type, Accumulator>
+    group_by(
+        Accumulator const& init, ///< initial value of each accumulator
+        Function&& fold, ///< function folding a value into an accumulator
+        Merge&& merge, ///< function merging an accumulator into another one
+        parallel const& executor ///< executor to use
+    ) const {
+        std::vector<std::map<
+            typename Bundle::template property_by_key<key>::type,
+            Accumulator
+        >> groups(threads(executor));
+        evaluate(groups.size(), [&] (
+            std::size_t part,
+            Iterator first,
+            Iterator last
+        ) {
+            group_by<key>(first, last, groups[part], init, fold);
+        });
+
+        auto retval = std::move(groups.front());
+        for (auto part = std::next(groups.begin()); part != groups.end(); ++part)
+            for (auto& group : *part) {
+                auto const inserted = retval.emplace(
+                    group.first,
+                    std::move(group.second)
+                );
+                if (!inserted.second)
+                    merge(inserted.first->second, std::move(group.second));
+            }
+        return retval;
+    }
+
+
+private:
+    template <
+        typename Function
+    >
+    void
+    for_each(
+        Iterator first,
+        Iterator last,
+        Function& function
+    ) const {
+        for (auto it = first; it != last; ++it)
+            if (_filter(_bundle, *it))
+                function(_projection(_bundle, *it));
+    }
+
+    std::size_t
+    count(
+        Iterator first,
+        Iterator last
+    ) const {
+        std::size_t retval = 0;
+        for (auto it = first; it != last; ++it)
+            if (_filter(_bundle, *it))
+                ++retval;
+        return retval;
+    }
+
+    template <
+        key_type key,
+        typename Groups,
+        typename Accumulator,
+        typename Function
+    >
+    void
+    group_by(
+        Iterator first,
+        Iterator last,
+        Groups& groups,
+        Accumulator const& init,
+        Function& fold
+    ) const {
+        for (auto it = first; it != last; ++it) {
+            if (!_filter(_bundle, *it))
+                continue;
+            auto group = groups.emplace(
+                _bundle.template get<key>(*it),
+                init
+            ).first;
+            fold(group->second, _projection(_bundle, *it));
+        }
+    }
+
+    /**
+     * Get the number of threads to use for evaluating an operation
+     */
+    std::size_t
+    threads(
+        parallel const& executor
+    ) const {
+        return util::thread_count(
+            static_cast<std::size_t>(std::distance(_first, _last)),
+            executor.grain,
+            executor.threads
+        );
+    }
+
+    /**
+     * Call a function for contiguous parts of the sequence, in parallel
+     *
+     * The function is called with the number of the part and its bounds.
+     */
+    template <
+        typename Function
+    >
+    void
+    evaluate(
+        std::size_t parts,
+        Function const& function
+    ) const {
+        auto const count = static_cast<std::size_t>(std::distance(_first, _last));
+        util::parallel_for(count, parts, [&] (
+            std::size_t part,
+            std::size_t begin,
+            std::size_t end
+        ) {
+            auto const first = std::next(_first, begin);
+            function(part, first, std::next(first, end - begin));
+        });
+    }
+
+    Bundle const& _bundle;
+    Iterator _first;
+    Iterator _last;
+    Filter _filter;
+    Projection _projection;
+};
+
+
+}
+
+
+/**
+ * Create a query pipeline over a sequence of objects
+ *
+ * \returns a pipeline passing on all the objects in the sequence
+ */
+template <
+    typename Bundle, ///< accessor bundle to use for accessing attributes
+    typename Iterator ///< type of the iterators
+>
+query::pipeline<Bundle, Iterator>
+from(
+    Bundle const& bundle, ///< accessor bundle to use for accessing attributes
+    Iterator first, ///< start of the sequence of objects
+    Iterator last ///< end of the sequence of objects
+) {
+    return query::pipeline<Bundle, Iterator>(bundle, first, last);
+}
+
+/**
+ * Create a query pipeline over a range of objects
+ *
+ * \returns a pipeline passing on all the objects in the range
+ */
+template <
+    typename Bundle, ///< accessor bundle to use for accessing attributes
+    typename Range ///< type of the range
+>
+query::pipeline<Bundle, decltype(std::begin(std::declval<Range const&>()))>
+from(
+    Bundle const& bundle, ///< accessor bundle to use for accessing attributes
+    Range const& range ///< range of objects
+) {
+    return from(bundle, std::begin(range), std::end(range));
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,605 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_REGISTRY_HPP__
+#define CMOH_REGISTRY_HPP__
+
+
+// std includes
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// local includes
+#include <cmoh/dynamic_bundle.hpp>
+#include <cmoh/encoding.hpp>
+#include <cmoh/hash.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Registry mapping type names and tags to accessor bundles
+ *
+ * A registry records accessor bundles under a name and the tag of their object
+ * type. For each registered type, the registry provides functions for creating
+ * objects from an encoded payload and for serializing objects to such a
+ * payload. The payload consists of the values of a list of attributes, given
+ * at registration, encoded using `cmoh::encoding::codec`.
+ *
+ * Registration takes place during a startup phase, which ends with a call to
+ * `freeze()`. Freezing builds perfect hash tables for both names and tags.
+ * Afterwards, no more types can be registered and lookups neither lock nor
+ * allocate. Hence, any number of threads may perform lookups concurrently.
+ * Before a registry is frozen, lookups perform a linear search and must not be
+ * performed concurrently with registrations.
+ *
+ * Neither the bundles nor the names are copied by the registry. Both must
+ * outlive the registry, e.g. by having static storage duration.
+ */
+template <
+    typename KeyType ///< key type of the bundles registered
+>
+class type_registry {
+public:
+    typedef KeyType key_type;
+    typedef encoding::byte byte;
+
+
+    /**
+     * Registry entry describing a single type
+     */
+    struct entry {
+        char const* name; ///< name under which the type is registered
+        std::size_t name_size; ///< length of the name
+        type_tag type; ///< tag of the type
+        std::size_t size; ///< size of objects of the type
+        std::size_t alignment; ///< alignment of objects of the type
+        void const* bundle; ///< bundle passed to the functions below
+
+        /// Create an object in storage from an encoded payload
+        void* (*create)(
+            void const* bundle,
+            void* storage,
+            byte const*& pos,
+            byte const* end
+        );
+        /// Append the encoded payload of an object to a buffer
+        void (*serialize)(
+            void const* bundle,
+            void const* obj,
+            std::vector<byte>& buffer
+        );
+        /// Destroy an object
+        void (*destroy)(void* obj);
+    };
+
+
+    type_registry() = default;
+    type_registry(type_registry const&) = delete;
+    type_registry(type_registry&&) = delete;
+
+    type_registry& operator=(type_registry const&) = delete;
+    type_registry& operator=(type_registry&&) = delete;
+
+
+    /**
+     * Get the global registry for the key type
+     */
+    static
+    type_registry&
+    global() {
+        static type_registry instance;
+        return instance;
+    }
+
+
+    /**
+     * Register a bundle under a name
+     *
+     * Objects are created from and serialized to the values of the attributes
+     * identified by `keys`, in that order. Objects are created via the bundle's
+     * `create_at()` method.
+     *
+     * \returns true if the bundle was registered, false if the registry is
+     *          frozen or the name or object type is already registered
+     */
+    template <
+        key_type ...keys, ///< keys of attributes making up the payload
+        typename Bundle ///< type of the bundle to register
+    >
+    bool
+    add(
+        char const* name, ///< name under which to register the bundle
+        Bundle const& bundle ///< bundle to register
+    ) {
+        typedef typename Bundle::object_type object_type;
+
+        auto const name_size = std::strlen(name);
+        if (frozen() || find(name, name_size) || find(tag_of<object_type>()))
+            return false;
+
+        _entries.push_back(entry{
+            name,
+            name_size,
+            tag_of<object_type>(),
+            sizeof(object_type),
+            alignof(object_type),
+            &bundle,
+            &creator<Bundle, key_list<keys...>, key_list<keys...>>::create,
+            &serialize_thunk<Bundle, keys...>,
+            &destroy_thunk<object_type>
+        });
+        return true;
+    }
+
+    /**
+     * End the registration phase
+     *
+     * Builds perfect hash tables for names and tags.
+     */
+    void
+    freeze() {
+        if (frozen())
+            return;
+
+        build(_by_name, [this] (std::size_t i, std::uint64_t seed) {
+            return hash(_entries[i].name, _entries[i].name_size, seed);
+        });
+        build(_by_type, [this] (std::size_t i, std::uint64_t seed) {
+            return hash(_entries[i].type, seed);
+        });
+        _frozen.store(true, std::memory_order_release);
+    }
+
+    /**
+     * Check whether the registry is frozen
+     */
+    bool
+    frozen() const noexcept {
+        return _frozen.load(std::memory_order_acquire);
+    }
+
+
+    entry const* begin() const noexcept { return _entries.data(); }
+    entry const* end() const noexcept { return _entries.data() + _entries.size(); }
+
+
+    /**
+     * Look up a type by its name
+     *
+     * \returns the entry for the type or null, if no such type is registered
+     */
+    entry const*
+    find(
+        char const* name, ///< name of the type
+        std::size_t name_size ///< length of the name
+    ) const noexcept {
+        auto matches = [name, name_size] (entry const& e) {
+            return (e.name_size == name_size) &&
+                (std::memcmp(e.name, name, name_size) == 0);
+        };
+
+        if (!frozen()) {
+            for (auto const& e : _entries)
+                if (matches(e))
+                    return &e;
+            return nullptr;
+        }
+
+        auto const index = _by_name.find(hash(name, name_size, _by_name.seed));
+        if ((index == npos) || !matches(_entries[index]))
+            return nullptr;
+        return &_entries[index];
+    }
+
+    // overload for null-terminated names
+    entry const*
+    find(
+        char const* name
+    ) const noexcept {
+        return find(name, std::strlen(name));
+    }
+
+    /**
+     * Look up a type by its tag
+     *
+     * \returns the entry for the type or null, if no such type is registered
+     */
+    entry const*
+    find(
+        type_tag type ///< tag of the type
+    ) const noexcept {
+        if (!frozen()) {
+            for (auto const& e : _entries)
+                if (e.type == type)
+                    return &e;
+            return nullptr;
+        }
+
+        auto const index = _by_type.find(hash(type, _by_type.seed));
+        if ((index == npos) || (_entries[index].type != type))
+            return nullptr;
+        return &_entries[index];
+    }
+
+
+    /**
+     * Create an object of a type given by name from an encoded payload
+     *
+     * The object is created in the storage supplied, which must be at least
+     * `size` bytes large and aligned to `alignment`, as given in the type's
+     * entry. On success, `pos` is advanced past the payload. The object may be
+     * destroyed via the entry's `destroy` function.
+     *
+     * \returns a pointer to the object created or null, if the type is not
+     *          registered, the storage is not suitable or the payload is
+     *          malformed
+     */
+    void*
+    create_by_name(
+        char const* name, ///< name of the type
+        std::size_t name_size, ///< length of the name
+        void* storage, ///< storage in which to create the object
+        std::size_t storage_size, ///< size of the storage
+        byte const*& pos, ///< position from which to read the payload
+        byte const* end ///< end of the payload
+    ) const {
+        auto const e = find(name, name_size);
+        if (!e || (storage_size < e->size) ||
+            (reinterpret_cast<std::uintptr_t>(storage) % e->alignment))
+            return nullptr;
+
+        auto current = pos;
+        auto const retval = e->create(e->bundle, storage, current, end);
+        if (retval)
+            pos = current;
+        return retval;
+    }
+
+    /**
+     * Serialize an object of any registered type
+     *
+     * \returns true if the payload was appended to the buffer, false if the
+     *          type is not registered
+     */
+    bool
+    serialize_any(
+        type_tag type, ///< tag of the object's type
+        void const* obj, ///< object to serialize
+        std::vector<byte>& buffer ///< buffer to which to append the payload
+    ) const {
+        auto const e = find(type);
+        if (!e)
+            return false;
+        e->serialize(e->bundle, obj, buffer);
+        return true;
+    }
+
+    // overload for objects of a type known at compile time
+    template <
+        typename Type
+    >
+    bool
+    serialize_any(
+        Type const& obj,
+        std::vector<byte>& buffer
+    ) const {
+        return serialize_any(tag_of<Type>(), &obj, buffer);
+    }
+
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+
+    /**
+     * Perfect hash table over all entries
+     *
+     * The table uses two-level hash-and-displace: entries are distributed to
+     * buckets of about four entries via their hash. For each bucket, the
+     * table holds a displacement which, mixed with the hash, maps the bucket's
+     * entries to slots not occupied by other entries. The table has about
+     * 1.25 slots per entry.
+     */
+    struct perfect_table {
+        std::uint64_t seed = 0; ///< seed used for hashing keys
+        std::vector<std::uint64_t> displacements; ///< displacement by bucket
+        std::vector<std::size_t> slots; ///< index of the entry or `npos`
+
+        /**
+         * Get the slot for a hash
+         *
+         * \returns the index of the only entry which may have the hash or
+         *          `npos`
+         */
+        std::size_t
+        find(
+            std::uint64_t hash ///< hash computed with `seed`
+        ) const noexcept {
+            auto const displacement = displacements[
+                (hash >> 32) % displacements.size()
+            ];
+            return slots[hashing::mix(displacement, hash) % slots.size()];
+        }
+    };
+
+
+    template <
+        key_type ...keys
+    >
+    struct key_list {};
+
+
+    /**
+     * Decoding of values and creation of objects
+     *
+     * The values of the attributes in `Remaining` are decoded one by one and
+     * passed on. Once all values are decoded, the object is created from the
+     * attributes in `All`.
+     */
+    template <
+        typename Bundle,
+        typename All,
+        typename Remaining
+    >
+    struct creator;
+
+    template <
+        typename Bundle,
+        key_type ...all,
+        key_type key0,
+        key_type ...remaining
+    >
+    struct creator<Bundle, key_list<all...>, key_list<key0, remaining...>> {
+        template <
+            typename ...Values
+        >
+        static
+        void*
+        create(
+            void const* bundle,
+            void* storage,
+            byte const*& pos,
+            byte const* end,
+            Values&&... values
+        ) {
+            typedef typename std::remove_cv<
+                typename Bundle::template property_by_key<key0>::type
+            >::type value_type;
+
+            value_type value;
+            if (!encoding::codec<value_type>::decode(pos, end, value))
+                return nullptr;
+            return creator<Bundle, key_list<all...>, key_list<remaining...>>::create(
+                bundle,
+                storage,
+                pos,
+                end,
+                std::forward<Values>(values)...,
+                std::move(value)
+            );
+        }
+    };
+
+    template <
+        typename Bundle,
+        key_type ...all
+    >
+    struct creator<Bundle, key_list<all...>, key_list<>> {
+        template <
+            typename ...Values
+        >
+        static
+        void*
+        create(
+            void const* bundle,
+            void* storage,
+            byte const*&,
+            byte const*,
+            Values&&... values
+        ) {
+            return static_cast<Bundle const*>(bundle)->template create_at<all...>(
+                storage,
+                std::forward<Values>(values)...
+            );
+        }
+    };
+
+
+    template <
+        typename Bundle,
+        key_type ...keys
+    >
+    static
+    void
+    serialize_thunk(
+        void const* bundle,
+        void const* obj,
+        std::vector<byte>& buffer
+    ) {
+        auto const& b = *static_cast<Bundle const*>(bundle);
+        auto const& o = *static_cast<typename Bundle::object_type const*>(obj);
+        (void) std::initializer_list<int>{(
+            encoding::codec<typename std::remove_cv<
+                typename Bundle::template property_by_key<keys>::type
+            >::type>::encode(buffer, b.template get<keys>(o)),
+            0
+        )...};
+    }
+
+    template <
+        typename Type
+    >
+    static
+    void
+    destroy_thunk(
+        void* obj
+    ) {
+        static_cast<Type*>(obj)->~Type();
+    }
+
+
+    static
+    std::uint64_t
+    hash(
+        char const* name,
+        std::size_t name_size,
+        std::uint64_t seed
+    ) noexcept {
+        // FNV-1a, mixed with the seed
+        std::uint64_t retval = 0xcbf29ce484222325ull;
+        for (std::size_t i = 0; i < name_size; ++i)
+            retval = (retval ^ static_cast<unsigned char>(name[i])) * 0x100000001b3ull;
+        return hashing::mix(seed, retval);
+    }
+
+    static
+    std::uint64_t
+    hash(
+        type_tag type,
+        std::uint64_t seed
+    ) noexcept {
+        return hashing::mix(seed, reinterpret_cast<std::uintptr_t>(type));
+    }
+
+
+    /**
+     * Build a perfect hash table over all entries
+     *
+     * Buckets are processed from the largest to the smallest. For each bucket,
+     * displacements are tried until all of its entries map to free slots. If
+     * no suitable displacement is found for a bucket, the table is rebuilt
+     * using another seed. The table grows slightly every few seeds, which
+     * guarantees termination.
+     */
+    template <
+        typename Hash
+    >
+    void
+    build(
+        perfect_table& table,
+        Hash&& hash_of
+    ) const {
+        auto const count = _entries.size();
+        auto const bucket_count = count / 4 + 1;
+        auto size = count + count / 4 + 1;
+
+        std::vector<std::uint64_t> hashes(count);
+        std::vector<std::vector<std::size_t>> buckets(bucket_count);
+        std::vector<std::size_t> order(bucket_count);
+
+        for (std::uint64_t seed = 0; ; ++seed) {
+            if ((seed > 0) && (seed % 16 == 0))
+                size += size / 8 + 1;
+
+            for (auto& bucket : buckets)
+                bucket.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                hashes[i] = hash_of(i, seed);
+                buckets[(hashes[i] >> 32) % bucket_count].push_back(i);
+            }
+
+            for (std::size_t b = 0; b < bucket_count; ++b)
+                order[b] = b;
+            std::stable_sort(
+                order.begin(),
+                order.end(),
+                [&buckets] (std::size_t lhs, std::size_t rhs) {
+                    return buckets[lhs].size() > buckets[rhs].size();
+                }
+            );
+
+            table.seed = seed;
+            table.displacements.assign(bucket_count, 0);
+            table.slots.assign(size, npos);
+
+            auto placed = [&] (std::vector<std::size_t> const& bucket) {
+                for (std::uint64_t d = 0; d < max_displacement; ++d) {
+                    std::size_t j = 0;
+                    for (; j < bucket.size(); ++j) {
+                        auto& slot = table.slots[
+                            hashing::mix(d, hashes[bucket[j]]) % size
+                        ];
+                        if (slot != npos)
+                            break;
+                        slot = bucket[j];
+                    }
+                    if (j == bucket.size())
+                        return d;
+
+                    // release the slots taken by this attempt
+                    while (j-- > 0)
+                        table.slots[hashing::mix(d, hashes[bucket[j]]) % size] =
+                            npos;
+                }
+                return max_displacement;
+            };
+
+            std::size_t b = 0;
+            for (; b < bucket_count; ++b) {
+                auto const d = placed(buckets[order[b]]);
+                if (d == max_displacement)
+                    break;
+                table.displacements[order[b]] = d;
+            }
+
+            if (b == bucket_count)
+                return;
+        }
+    }
+
+    // number of displacements tried for a bucket before choosing a new seed
+    static constexpr std::uint64_t max_displacement = 1 << 16;
+
+
+    std::vector<entry> _entries;
+    perfect_table _by_name;
+    perfect_table _by_type;
+    std::atomic<bool> _frozen{false};
+};
+
+
+// definition of the static members, required if they are odr-used
+template <
+    typename KeyType
+>
+constexpr std::size_t type_registry<KeyType>::npos;
+
+template <
+    typename KeyType
+>
+constexpr std::uint64_t type_registry<KeyType>::max_displacement;
+
+
+}
+
+
+#endif
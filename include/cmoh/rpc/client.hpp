@@ -0,0 +1,419 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_RPC_CLIENT_HPP__
+#define CMOH_RPC_CLIENT_HPP__
+
+
+// std includes
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// POSIX includes
+#include <unistd.h>
+
+// local includes
+#include <cmoh/dispatcher.hpp>
+#include <cmoh/encoding.hpp>
+#include <cmoh/rpc/frame.hpp>
+#include <cmoh/rpc/socket.hpp>
+
+
+namespace cmoh {
+namespace rpc {
+
+
+/**
+ * Options controlling the queueing and batching of calls by a client
+ *
+ * By default, calls are queued until sent explicitly via `flush()` and each
+ * call is sent in a frame of its own.
+ */
+struct batch_options {
+    typedef std::chrono::steady_clock clock;
+
+    /**
+     * Whether to coalesce the calls queued into a single batch frame
+     */
+    bool coalesce = false;
+
+    /**
+     * Number of queued calls at which the calls are sent
+     */
+    std::size_t batch_size = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Number of queued bytes at which the calls are sent
+     */
+    std::size_t batch_bytes = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Maximum time a call is queued before being sent
+     *
+     * The time is only checked when a call is queued or `poll()` is called.
+     * The clock is only queried if a latency other than the maximum is set.
+     */
+    clock::duration flush_latency = clock::duration::max();
+
+    /**
+     * Maximum number of calls awaiting a response
+     */
+    std::size_t queue_depth = std::numeric_limits<std::size_t>::max();
+};
+
+
+/**
+ * Client calling methods on a remote object
+ *
+ * A client sends calls of the methods of an accessor bundle to a
+ * `cmoh::rpc::server` over a connected, blocking socket, e.g. a Unix domain
+ * socket. Each call is assigned a request id, which is returned by `call()`
+ * and carried by the response.
+ *
+ * Calls are queued until sent, either explicitly via `flush()` or when a
+ * window configured via `batch_options` is exceeded. Hence, any number of
+ * calls may be pipelined, i.e. sent with a single write without waiting for
+ * responses. If so configured, queued calls are coalesced into a single batch
+ * frame, which the server answers with a single response frame. Responses are
+ * received via `receive()` and decoded directly from the receive buffer.
+ */
+template <
+    typename Bundle ///< accessor bundle providing the methods
+>
+class client {
+public:
+    typedef typename Bundle::key_type key_type;
+    typedef dispatcher<Bundle> dispatcher_type;
+    typedef batch_options::clock clock;
+
+    /**
+     * Id returned by `call()` if the queue depth was reached
+     */
+    static constexpr std::uint64_t busy = std::numeric_limits<std::uint64_t>::max();
+
+    /**
+     * Id returned by `call()` if sending the calls queued failed
+     */
+    static constexpr std::uint64_t failed = std::numeric_limits<std::uint64_t>::max() - 1;
+
+
+    /**
+     * Create a client communicating via a socket
+     *
+     * The client takes ownership of the socket.
+     */
+    explicit client(
+        int fd, ///< connected socket
+        batch_options const& options = batch_options() ///< batching options
+    ) : _fd(fd),
+        _options(options),
+        _next_id(0),
+        _pending(0),
+        _queued(0),
+        _batch(0),
+        _broken(false) {}
+    client(client const&) = delete;
+    client(client&&) = delete;
+
+    client& operator=(client const&) = delete;
+    client& operator=(client&&) = delete;
+
+    ~client() {
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+
+    /**
+     * Queue a call of a specific method
+     *
+     * If the call completes a batch, i.e. if the number of calls or bytes
+     * queued reaches the configured batch size or the oldest call queued
+     * exceeds the flush latency, all calls queued are sent. If the number of
+     * calls awaiting a response reached the queue depth, the call is not
+     * queued and `busy` is returned. In this case, responses have to be
+     * received first.
+     *
+     * If sending the calls fails, the connection is considered broken and
+     * `failed` is returned, both for this and any further call.
+     *
+     * \returns the request id of the call, `busy` or `failed`
+     */
+    template <
+        key_type key, ///< key of the method to call
+        typename ...Args ///< types of the arguments
+    >
+    std::uint64_t
+    call(
+        Args const&... args ///< arguments to pass
+    ) {
+        if (_broken)
+            return failed;
+        if (_pending >= _options.queue_depth)
+            return busy;
+
+        auto const id = _next_id++;
+        if (_queued == 0)
+            open(id);
+
+        if (_options.coalesce) {
+            auto const nested = begin_frame(_output);
+            dispatcher_type::template encode_call<key>(_output, args...);
+            end_frame(_output, nested);
+        } else {
+            auto const frame = begin_frame(_output);
+            _output.push_back(static_cast<byte>(frame_kind::call));
+            encoding::write_varint(_output, id);
+            dispatcher_type::template encode_call<key>(_output, args...);
+            end_frame(_output, frame);
+        }
+        ++_pending;
+        ++_queued;
+
+        auto const sent = (_queued >= _options.batch_size) ||
+            (_output.size() >= _options.batch_bytes) ? flush() : poll();
+        return sent ? id : failed;
+    }
+
+    /**
+     * Send all queued calls
+     *
+     * If the calls could not be sent completely, the connection is considered
+     * broken. The calls are no longer counted as pending, since no response
+     * will arrive for them.
+     *
+     * \returns true on success, false otherwise
+     */
+    bool
+    flush() {
+        if (_broken)
+            return false;
+        if (_queued == 0)
+            return true;
+        if (_options.coalesce)
+            end_frame(_output, _batch);
+
+        auto const written = write_some(_fd, _output.data(), _output.size());
+        if (written != _output.size()) {
+            _broken = true;
+            _pending -= _queued;
+        }
+        _output.clear();
+        _queued = 0;
+        return !_broken;
+    }
+
+    /**
+     * Check whether the connection is broken
+     *
+     * A connection is broken if sending calls or receiving responses failed.
+     * No further calls may be made over a broken connection.
+     */
+    bool
+    broken() const noexcept {
+        return _broken;
+    }
+
+    /**
+     * Send all queued calls if the oldest one exceeded the flush latency
+     *
+     * \returns true on success or if nothing was sent, false otherwise
+     */
+    bool
+    poll() {
+        if ((_queued == 0) || (_options.flush_latency == clock::duration::max()))
+            return true;
+        if (clock::now() - _oldest < _options.flush_latency)
+            return true;
+        return flush();
+    }
+
+    /**
+     * Get the number of calls for which no response was received yet
+     */
+    std::size_t
+    pending() const noexcept {
+        return _pending;
+    }
+
+    /**
+     * Get the number of calls queued but not yet sent
+     */
+    std::size_t
+    queued() const noexcept {
+        return _queued;
+    }
+
+
+    /**
+     * Receive responses
+     *
+     * Sends all queued calls and blocks until at least one response is
+     * received. For each response, the `handler` is called with the request
+     * id, a bool indicating whether the method was invoked and the range
+     * holding the encoded value returned by the method. The value may be
+     * decoded via the dispatcher's `decode_result()`. Responses to batches
+     * are passed to the handler one by one.
+     *
+     * \returns the number of responses received or a negative value, if the
+     *          connection was closed, is broken or an error occurred
+     */
+    template <
+        typename Handler ///< type of the handler
+    >
+    int
+    receive(
+        Handler&& handler ///< handler to call for each response
+    ) {
+        if (!flush())
+            return -1;
+
+        auto const retval = receive_some(handler);
+        if (retval < 0)
+            _broken = true;
+        return retval;
+    }
+
+
+private:
+    // receive at least one response, unless an error occurs
+    template <
+        typename Handler
+    >
+    int
+    receive_some(
+        Handler& handler
+    ) {
+        int retval = 0;
+        while (retval == 0) {
+            auto const count = _input.fill(_fd);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return -1;
+
+            byte const* pos;
+            byte const* end;
+            while (_input.next(pos, end)) {
+                if (pos == end)
+                    return -1;
+                auto const kind = *pos++;
+                std::uint64_t id;
+                if (!encoding::read_varint(pos, end, id))
+                    return -1;
+
+                if (kind == static_cast<byte>(frame_kind::call)) {
+                    if (!respond(handler, id, pos, end))
+                        return -1;
+                    ++retval;
+                } else if (kind == static_cast<byte>(frame_kind::batch)) {
+                    byte const* response_begin;
+                    byte const* response_end;
+                    while (read_frame(pos, end, response_begin, response_end)) {
+                        if (!respond(handler, id++, response_begin, response_end))
+                            return -1;
+                        ++retval;
+                    }
+                } else {
+                    return -1;
+                }
+            }
+            if (_input.failed())
+                return -1;
+        }
+        return retval;
+    }
+
+    /**
+     * Start queueing calls, beginning with the call with the id supplied
+     */
+    void
+    open(
+        std::uint64_t id
+    ) {
+        if (_options.flush_latency != clock::duration::max())
+            _oldest = clock::now();
+        if (_options.coalesce) {
+            _batch = begin_frame(_output);
+            _output.push_back(static_cast<byte>(frame_kind::batch));
+            encoding::write_varint(_output, id);
+        }
+    }
+
+    /**
+     * Pass a single response to a handler
+     */
+    template <
+        typename Handler
+    >
+    bool
+    respond(
+        Handler& handler,
+        std::uint64_t id,
+        byte const* pos,
+        byte const* end
+    ) {
+        if (pos == end)
+            return false;
+        auto const success = *pos++ == static_cast<byte>(status::ok);
+        handler(id, success, pos, end);
+        --_pending;
+        return true;
+    }
+
+
+    int _fd;
+    batch_options _options;
+    std::uint64_t _next_id;
+    std::size_t _pending;
+    std::size_t _queued;
+    std::size_t _batch;
+    bool _broken;
+    clock::time_point _oldest;
+    std::vector<byte> _output;
+    frame_reader _input;
+};
+
+
+// definition of the static member, required if it is odr-used
+template <
+    typename Bundle
+>
+constexpr std::uint64_t client<Bundle>::busy;
+
+template <
+    typename Bundle
+>
+constexpr std::uint64_t client<Bundle>::failed;
+
+
+}
+}
+
+
+#endif
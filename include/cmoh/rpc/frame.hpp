@@ -0,0 +1,243 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_RPC_FRAME_HPP__
+#define CMOH_RPC_FRAME_HPP__
+
+
+// std includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// POSIX includes
+#include <sys/types.h>
+#include <unistd.h>
+
+// local includes
+#include <cmoh/encoding.hpp>
+
+
+namespace cmoh {
+namespace rpc {
+
+
+typedef encoding::byte byte;
+
+
+/**
+ * Kinds of frames exchanged between clients and servers
+ *
+ * The kind is the first byte of every frame's payload. It is followed by the
+ * request's id, encoded as a varint. In batches, the id is the one of the first
+ * call, with the ids of subsequent calls following consecutively. A batch's
+ * response is a single batch holding the responses in the order of the calls.
+ */
+enum class frame_kind : byte {
+    call = 0, ///< a single call, as encoded by a dispatcher
+    batch = 1 ///< a sequence of nested frames, each holding a single call
+};
+
+
+/**
+ * Status of a call, preceding the value returned in a response
+ */
+enum class status : byte {
+    ok = 0, ///< the method was invoked, the value returned follows
+    failed = 1 ///< the call was malformed or the method unknown
+};
+
+
+/**
+ * Maximum size of a frame's payload accepted
+ */
+constexpr std::size_t max_frame_size = static_cast<std::size_t>(1) << 24;
+
+
+/**
+ * Start a frame in a buffer
+ *
+ * Frames consist of the size of their payload, encoded as a 32 bit little
+ * endian integer, followed by the payload. This function appends a placeholder
+ * for the size, which is filled in by `end_frame()` once the payload was
+ * appended.
+ *
+ * \returns the offset of the frame within the buffer
+ */
+inline
+std::size_t
+begin_frame(
+    std::vector<byte>& buffer ///< buffer to which to append the frame
+) {
+    auto const retval = buffer.size();
+    buffer.insert(buffer.end(), 4, 0);
+    return retval;
+}
+
+
+/**
+ * Finish a frame started via `begin_frame()`
+ */
+inline
+void
+end_frame(
+    std::vector<byte>& buffer, ///< buffer holding the frame
+    std::size_t offset ///< offset of the frame
+) {
+    auto size = static_cast<std::uint32_t>(buffer.size() - offset - 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+        buffer[offset + i] = static_cast<byte>(size);
+        size >>= 8;
+    }
+}
+
+
+/**
+ * Read a frame from a range of bytes
+ *
+ * This function is used for reading frames nested within another frame. On
+ * success, `pos` is advanced past the frame.
+ *
+ * \returns true if a complete frame was read, false otherwise
+ */
+inline
+bool
+read_frame(
+    byte const*& pos, ///< position from which to read
+    byte const* end, ///< end of the range
+    byte const*& payload_begin, ///< beginning of the frame's payload
+    byte const*& payload_end ///< end of the frame's payload
+) noexcept {
+    if (end - pos < 4)
+        return false;
+
+    std::size_t size = 0;
+    for (std::size_t i = 4; i > 0; --i)
+        size = (size << 8) | pos[i - 1];
+    if (static_cast<std::size_t>(end - pos - 4) < size)
+        return false;
+
+    payload_begin = pos + 4;
+    payload_end = payload_begin + size;
+    pos = payload_end;
+    return true;
+}
+
+
+/**
+ * Reader splitting a stream of bytes into frames
+ *
+ * Data is read from a file descriptor into a buffer owned by the reader. Frames
+ * are exposed as ranges within that buffer. Hence, calls may be decoded
+ * directly from the data received, without copying it. A range stays valid
+ * until the next call to `fill()`.
+ */
+class frame_reader {
+public:
+    frame_reader() : _begin(0), _end(0), _failed(false) {}
+    frame_reader(frame_reader const&) = delete;
+    frame_reader(frame_reader&&) = default;
+
+    frame_reader& operator=(frame_reader const&) = delete;
+    frame_reader& operator=(frame_reader&&) = default;
+
+
+    /**
+     * Read data from a file descriptor
+     *
+     * \returns the number of bytes read, zero at the end of the stream or a
+     *          negative value on error, with `errno` set accordingly
+     */
+    ssize_t
+    fill(
+        int fd ///< file descriptor from which to read
+    ) {
+        // move any partial frame to the front of the buffer
+        if (_begin > 0) {
+            std::copy(_buffer.begin() + _begin, _buffer.begin() + _end, _buffer.begin());
+            _end -= _begin;
+            _begin = 0;
+        }
+
+        if (_buffer.size() - _end < chunk_size)
+            _buffer.resize(_end + chunk_size);
+
+        auto const retval = ::read(fd, _buffer.data() + _end, _buffer.size() - _end);
+        if (retval > 0)
+            _end += static_cast<std::size_t>(retval);
+        return retval;
+    }
+
+    /**
+     * Get the payload of the next complete frame
+     *
+     * \returns true if a complete frame was available, false otherwise
+     */
+    bool
+    next(
+        byte const*& begin, ///< beginning of the payload
+        byte const*& end ///< end of the payload
+    ) noexcept {
+        if (_end - _begin < 4)
+            return false;
+
+        std::size_t size = 0;
+        for (std::size_t i = 4; i > 0; --i)
+            size = (size << 8) | _buffer[_begin + i - 1];
+        if (size > max_frame_size) {
+            _failed = true;
+            return false;
+        }
+        if (_end - _begin - 4 < size)
+            return false;
+
+        begin = _buffer.data() + _begin + 4;
+        end = begin + size;
+        _begin += 4 + size;
+        return true;
+    }
+
+    /**
+     * Check whether a frame exceeding the maximum size was encountered
+     */
+    bool
+    failed() const noexcept {
+        return _failed;
+    }
+
+private:
+    static constexpr std::size_t chunk_size = 64*1024;
+
+    std::vector<byte> _buffer;
+    std::size_t _begin;
+    std::size_t _end;
+    bool _failed;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_RPC_REACTOR_HPP__
+#define CMOH_RPC_REACTOR_HPP__
+
+
+#ifdef __linux__
+
+
+// std includes
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+// POSIX includes
+#include <sys/epoll.h>
+#include <unistd.h>
+
+
+namespace cmoh {
+namespace rpc {
+
+
+/**
+ * Event loop based on epoll
+ *
+ * A reactor waits for events on file descriptors registered via watches and
+ * calls the watches' callbacks. It is not synchronized and is meant to be run
+ * by a single thread. The header is only available on Linux.
+ */
+class reactor {
+public:
+    /**
+     * Registration of a file descriptor
+     *
+     * Watches are owned by the user, who typically derives from this struct in
+     * order to associate state with the file descriptor. The callback is called
+     * with the watch and the epoll events occurred.
+     */
+    struct watch {
+        int fd; ///< file descriptor watched
+        void (*callback)(watch& w, std::uint32_t events); ///< event handler
+    };
+
+
+    reactor() : _fd(::epoll_create1(EPOLL_CLOEXEC)), _watches(0), _stopped(false) {}
+    reactor(reactor const&) = delete;
+    reactor(reactor&&) = delete;
+
+    reactor& operator=(reactor const&) = delete;
+    reactor& operator=(reactor&&) = delete;
+
+    ~reactor() {
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+
+    /**
+     * Check whether the reactor was set up successfully
+     */
+    bool
+    valid() const noexcept {
+        return _fd >= 0;
+    }
+
+    /**
+     * Get the number of watches registered
+     */
+    std::size_t
+    watches() const noexcept {
+        return _watches;
+    }
+
+
+    /**
+     * Register a watch for specific events
+     *
+     * The watch must stay valid until it is removed.
+     *
+     * \returns true on success, false otherwise
+     */
+    bool
+    add(
+        watch& w, ///< watch to register
+        std::uint32_t events ///< epoll events to wait for
+    ) noexcept {
+        if (!control(EPOLL_CTL_ADD, w, events))
+            return false;
+        ++_watches;
+        return true;
+    }
+
+    /**
+     * Change the events a watch waits for
+     *
+     * \returns true on success, false otherwise
+     */
+    bool
+    modify(
+        watch& w, ///< watch to modify
+        std::uint32_t events ///< epoll events to wait for
+    ) noexcept {
+        return control(EPOLL_CTL_MOD, w, events);
+    }
+
+    /**
+     * Remove a watch
+     *
+     * The watch may be destroyed afterwards, even from within its callback.
+     *
+     * \returns true on success, false otherwise
+     */
+    bool
+    remove(
+        watch& w ///< watch to remove
+    ) noexcept {
+        if (!control(EPOLL_CTL_DEL, w, 0))
+            return false;
+        --_watches;
+        return true;
+    }
+
+
+    /**
+     * Wait for events and call the callbacks of the watches affected
+     *
+     * \returns the number of events handled or a negative value on error
+     */
+    int
+    run_once(
+        int timeout = -1 ///< maximum time to wait in milliseconds
+    ) noexcept {
+        epoll_event events[max_events];
+        auto const count = ::epoll_wait(_fd, events, max_events, timeout);
+        if (count < 0)
+            return (errno == EINTR) ? 0 : -1;
+
+        for (int i = 0; i < count; ++i) {
+            auto& w = *static_cast<watch*>(events[i].data.ptr);
+            w.callback(w, events[i].events);
+        }
+        return count;
+    }
+
+    /**
+     * Handle events until stopped or no watch is registered any more
+     *
+     * \returns true if the loop ended regularly, false on error
+     */
+    bool
+    run() noexcept {
+        _stopped = false;
+        while (!_stopped && (_watches > 0))
+            if (run_once() < 0)
+                return false;
+        return true;
+    }
+
+    /**
+     * Stop the loop started via `run()`
+     *
+     * This method must be called from within a callback.
+     */
+    void
+    stop() noexcept {
+        _stopped = true;
+    }
+
+private:
+    static constexpr int max_events = 64;
+
+    bool
+    control(
+        int operation,
+        watch& w,
+        std::uint32_t events
+    ) noexcept {
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = &w;
+        return ::epoll_ctl(_fd, operation, w.fd, &event) == 0;
+    }
+
+
+    int _fd;
+    std::size_t _watches;
+    bool _stopped;
+};
+
+
+}
+}
+
+
+#endif
+
+
+#endif
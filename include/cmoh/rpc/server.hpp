@@ -0,0 +1,401 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_RPC_SERVER_HPP__
+#define CMOH_RPC_SERVER_HPP__
+
+
+#ifdef __linux__
+
+
+// std includes
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// POSIX includes
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// local includes
+#include <cmoh/encoding.hpp>
+#include <cmoh/rpc/frame.hpp>
+#include <cmoh/rpc/reactor.hpp>
+#include <cmoh/rpc/socket.hpp>
+
+
+namespace cmoh {
+namespace rpc {
+
+
+/**
+ * Server invoking methods on an object on behalf of remote clients
+ *
+ * A server accepts frames carrying calls, as sent by a `cmoh::rpc::client`,
+ * on any number of connections, e.g. Unix domain sockets. The calls are
+ * dispatched to a single object via a `cmoh::dispatcher` and the values
+ * returned are sent back in response frames carrying the same request id.
+ * Batches of calls are executed in one pass and answered with a single frame.
+ *
+ * Connections are handled by a reactor, without blocking. Clients may pipeline
+ * requests, i.e. send further requests before receiving responses. All
+ * requests received with a single read are processed in one go and their
+ * responses are sent with a single write. Calls are decoded directly from the
+ * receive buffer. Once the responses pending on a connection exceed
+ * `high_water_mark` bytes, the server stops reading from it until they are
+ * sent. If the peer shuts down its side of the connection, responses pending
+ * are sent before the connection is closed.
+ *
+ * The server, the dispatcher and the object must outlive the reactor's loop.
+ * The header is only available on Linux.
+ */
+template <
+    typename Dispatcher ///< dispatcher used for invoking methods
+>
+class server {
+public:
+    typedef Dispatcher dispatcher_type;
+    typedef typename Dispatcher::object_type object_type;
+
+    /// Number of bytes pending on a connection above which it is not read
+    static constexpr std::size_t high_water_mark = 1024*1024;
+
+
+    server(
+        reactor& r, ///< reactor handling the connections
+        Dispatcher const& dispatcher, ///< dispatcher used for invoking methods
+        object_type& obj ///< object on which to invoke the methods
+    ) : _reactor(r), _dispatcher(dispatcher), _object(obj) {}
+    server(server const&) = delete;
+    server(server&&) = delete;
+
+    server& operator=(server const&) = delete;
+    server& operator=(server&&) = delete;
+
+    ~server() {
+        for (auto& c : _connections)
+            close(*c);
+        if (_listener)
+            close(*_listener);
+    }
+
+
+    /**
+     * Serve a connected socket
+     *
+     * The server takes ownership of the socket, which is closed once the peer
+     * disconnects.
+     *
+     * \returns true on success, false otherwise
+     */
+    bool
+    serve(
+        int fd ///< connected socket
+    ) {
+        std::unique_ptr<connection> c(new connection(*this, fd));
+        if (!set_nonblocking(fd) || !_reactor.add(*c, EPOLLIN | EPOLLRDHUP)) {
+            ::close(fd);
+            return false;
+        }
+        _connections.push_back(std::move(c));
+        return true;
+    }
+
+    /**
+     * Accept and serve connections on a listening socket
+     *
+     * The server takes ownership of the socket. Only one listening socket is
+     * supported.
+     *
+     * \returns true on success, false otherwise
+     */
+    bool
+    listen(
+        int fd ///< listening socket
+    ) {
+        if (_listener || !set_nonblocking(fd)) {
+            ::close(fd);
+            return false;
+        }
+
+        _listener.reset(new listener(*this, fd));
+        if (!_reactor.add(*_listener, EPOLLIN)) {
+            ::close(fd);
+            _listener.reset();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Get the number of connections being served
+     */
+    std::size_t
+    connections() const noexcept {
+        return _connections.size();
+    }
+
+
+private:
+    struct connection : reactor::watch {
+        connection(server& s, int fd) : reactor::watch{fd, &on_event}, owner(s) {}
+
+        server& owner;
+        frame_reader input;
+        std::vector<byte> output;
+        std::size_t written = 0;
+        std::uint32_t events = EPOLLIN | EPOLLRDHUP; ///< events waited for
+        bool closing = false; ///< whether the peer will send no more requests
+    };
+
+    struct listener : reactor::watch {
+        listener(server& s, int fd) : reactor::watch{fd, &on_accept}, owner(s) {}
+
+        server& owner;
+    };
+
+
+    static
+    void
+    on_event(
+        reactor::watch& w,
+        std::uint32_t events
+    ) {
+        auto& c = static_cast<connection&>(w);
+        auto& s = c.owner;
+
+        if (events & EPOLLIN) {
+            if (!s.receive(c))
+                return s.drop(c);
+        } else if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+            return s.drop(c);
+        }
+
+        if (!s.send(c))
+            return s.drop(c);
+    }
+
+    static
+    void
+    on_accept(
+        reactor::watch& w,
+        std::uint32_t
+    ) {
+        auto& s = static_cast<listener&>(w).owner;
+        for (;;) {
+            auto const fd = ::accept4(w.fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0)
+                break;
+            s.serve(fd);
+        }
+    }
+
+
+    /**
+     * Read and process all available requests
+     *
+     * Reading stops once the responses pending exceed the high-water mark.
+     *
+     * \returns false if the connection is to be closed
+     */
+    bool
+    receive(
+        connection& c
+    ) {
+        while (c.output.size() <= high_water_mark) {
+            auto const count = c.input.fill(c.fd);
+            if (count == 0) {
+                c.closing = true;
+                break;
+            }
+            if (count < 0) {
+                if (errno == EINTR)
+                    continue;
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+                    break;
+                return false;
+            }
+
+            byte const* begin;
+            byte const* end;
+            while (c.input.next(begin, end))
+                process(c, begin, end);
+            if (c.input.failed())
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Process a single request frame
+     *
+     * Batches are processed in one pass, producing a single response frame.
+     */
+    void
+    process(
+        connection& c,
+        byte const* pos,
+        byte const* end
+    ) {
+        if (pos == end)
+            return;
+        auto const kind = *pos++;
+        std::uint64_t id = 0;
+        if (!encoding::read_varint(pos, end, id))
+            return;
+
+        if (kind == static_cast<byte>(frame_kind::call)) {
+            auto const frame = begin_frame(c.output);
+            c.output.push_back(kind);
+            encoding::write_varint(c.output, id);
+            respond(c, pos, end);
+            end_frame(c.output, frame);
+        } else if (kind == static_cast<byte>(frame_kind::batch)) {
+            auto const frame = begin_frame(c.output);
+            c.output.push_back(kind);
+            encoding::write_varint(c.output, id);
+
+            byte const* call_begin;
+            byte const* call_end;
+            while (read_frame(pos, end, call_begin, call_end)) {
+                auto const nested = begin_frame(c.output);
+                respond(c, call_begin, call_end);
+                end_frame(c.output, nested);
+            }
+            end_frame(c.output, frame);
+        }
+    }
+
+    /**
+     * Dispatch a single call and append the status and the value returned
+     */
+    void
+    respond(
+        connection& c,
+        byte const* pos,
+        byte const* end
+    ) {
+        auto const status_offset = c.output.size();
+        c.output.push_back(static_cast<byte>(status::ok));
+        if (!_dispatcher.dispatch(_object, pos, end, c.output) || (pos != end)) {
+            c.output.resize(status_offset + 1);
+            c.output[status_offset] = static_cast<byte>(status::failed);
+        }
+    }
+
+    /**
+     * Write pending responses
+     *
+     * Afterwards, the connection waits for the socket to become writable if
+     * responses are still pending and for requests if the responses pending
+     * do not exceed the high-water mark.
+     *
+     * \returns false if the connection is to be closed
+     */
+    bool
+    send(
+        connection& c
+    ) {
+        if (c.written < c.output.size()) {
+            c.written += write_some(
+                c.fd,
+                c.output.data() + c.written,
+                c.output.size() - c.written
+            );
+            if ((c.written < c.output.size()) &&
+                (errno != EAGAIN) && (errno != EWOULDBLOCK))
+                return false;
+        }
+
+        if (c.written == c.output.size()) {
+            // keep the capacity for subsequent responses
+            c.output.clear();
+            c.written = 0;
+            if (c.closing)
+                return false;
+        }
+
+        std::uint32_t events = 0;
+        if (!c.closing && (c.output.size() <= high_water_mark))
+            events |= EPOLLIN | EPOLLRDHUP;
+        if (c.written < c.output.size())
+            events |= EPOLLOUT;
+        if (events == c.events)
+            return true;
+        c.events = events;
+        return _reactor.modify(c, events);
+    }
+
+    /**
+     * Close a connection and release its state
+     */
+    void
+    drop(
+        connection& c
+    ) {
+        close(c);
+        auto const it = std::find_if(
+            _connections.begin(),
+            _connections.end(),
+            [&c] (std::unique_ptr<connection> const& p) { return p.get() == &c; }
+        );
+        if (it != _connections.end())
+            _connections.erase(it);
+    }
+
+    void
+    close(
+        reactor::watch& w
+    ) noexcept {
+        _reactor.remove(w);
+        ::close(w.fd);
+    }
+
+
+    reactor& _reactor;
+    Dispatcher const& _dispatcher;
+    object_type& _object;
+    std::vector<std::unique_ptr<connection>> _connections;
+    std::unique_ptr<listener> _listener;
+};
+
+
+// definition of the static member, required if it is odr-used
+template <
+    typename Dispatcher
+>
+constexpr std::size_t server<Dispatcher>::high_water_mark;
+
+
+}
+}
+
+
+#endif
+
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_RPC_SOCKET_HPP__
+#define CMOH_RPC_SOCKET_HPP__
+
+
+// std includes
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+// POSIX includes
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// local includes
+#include <cmoh/encoding.hpp>
+
+
+namespace cmoh {
+namespace rpc {
+
+
+/**
+ * Put a file descriptor into non-blocking mode
+ *
+ * \returns true on success, false otherwise
+ */
+inline
+bool
+set_nonblocking(
+    int fd ///< file descriptor to modify
+) noexcept {
+    auto const flags = ::fcntl(fd, F_GETFL);
+    return (flags >= 0) && (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+
+/**
+ * Write a range of bytes to a socket
+ *
+ * The function writes as many bytes as possible, retrying after interrupts.
+ * For blocking sockets, all bytes are written unless an error occurs. Writing
+ * to a socket whose peer disconnected does not raise `SIGPIPE`.
+ *
+ * \returns the number of bytes written, which is less than `size` if an error
+ *          occurred, e.g. if the socket would block
+ */
+inline
+std::size_t
+write_some(
+    int fd, ///< socket to write to
+    encoding::byte const* data, ///< data to write
+    std::size_t size ///< number of bytes to write
+) noexcept {
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+
+    std::size_t retval = 0;
+    while (retval < size) {
+        auto const written = ::send(fd, data + retval, size - retval, flags);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        retval += static_cast<std::size_t>(written);
+    }
+    return retval;
+}
+
+
+/**
+ * Create a Unix domain socket listening at a path
+ *
+ * Any file present at the path is removed first.
+ *
+ * \returns the listening socket or a negative value on error
+ */
+inline
+int
+unix_listen(
+    char const* path, ///< path at which to listen
+    int backlog = 64 ///< maximum number of pending connections
+) noexcept {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path))
+        return -1;
+    std::strcpy(address.sun_path, path);
+
+    auto const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    ::unlink(path);
+    if ((::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) ||
+        (::listen(fd, backlog) != 0)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+/**
+ * Connect to a Unix domain socket listening at a path
+ *
+ * \returns the connected socket or a negative value on error
+ */
+inline
+int
+unix_connect(
+    char const* path ///< path of the listening socket
+) noexcept {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path))
+        return -1;
+    std::strcpy(address.sun_path, path);
+
+    auto const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+}
+}
+
+
+#endif
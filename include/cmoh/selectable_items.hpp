@@ -24,6 +24,7 @@
 #ifndef CMOH_SELECTABLE_ITEMS_HPP__
 #define CMOH_SELECTABLE_ITEMS_HPP__
 
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 
@@ -72,6 +73,40 @@ struct selectable_items {
     visit(
         Function&& func ///< function to apply
     ) const {}
+
+    /**
+     * Visit items until the function returns true
+     *
+     * \returns true if the traversal was stopped by the function
+     */
+    template <
+        typename Function,
+        typename ...BoolTypes
+    >
+    bool
+    visit_until(
+        Function&& func ///< function to apply
+    ) const {
+        return false;
+    }
+
+    /**
+     * Visit the item with a specific index among the items selected
+     *
+     * \returns true if the function was called, false if the index is out of
+     *          range
+     */
+    template <
+        typename Function,
+        typename ...BoolTypes
+    >
+    bool
+    visit_at(
+        std::size_t index, ///< index of the item to visit
+        Function&& func ///< function to apply
+    ) const {
+        return false;
+    }
 };
 
 // Specialization for at least one parameter
@@ -134,7 +169,11 @@ public:
     >
     typename std::enable_if<
         !BoolType0::value,
-        typename next::template type_of<BoolTypes...>
+        typename std::add_lvalue_reference<
+            typename std::add_const<
+                typename next::template type_of<BoolTypes...>
+            >::type
+        >::type
     >::type
     get() const noexcept {
         return _next.template get<BoolTypes...>();
@@ -199,6 +238,162 @@ public:
             std::forward<Function>(func)
         );
     }
+
+
+    template <
+        typename Function,
+        typename BoolType0 = std::true_type,
+        typename ...BoolTypes
+    >
+    typename std::enable_if<BoolType0::value, bool>::type
+    visit_until(
+        Function&& func
+    ) const {
+        if (func(_value))
+            return true;
+        return _next.template visit_until<Function, BoolTypes...>(
+            std::forward<Function>(func)
+        );
+    }
+
+    template <
+        typename Function,
+        typename BoolType0 = std::true_type,
+        typename ...BoolTypes
+    >
+    typename std::enable_if<!BoolType0::value, bool>::type
+    visit_until(
+        Function&& func
+    ) const {
+        return _next.template visit_until<Function, BoolTypes...>(
+            std::forward<Function>(func)
+        );
+    }
+
+
+    /**
+     * Get the item at a specific position, regardless of any selection
+     */
+    template <
+        std::size_t Position ///< position of the item
+    >
+    typename std::enable_if<Position == 0, value const&>::type
+    item() const noexcept {
+        return _value;
+    }
+
+    template <
+        std::size_t Position
+    >
+    typename std::enable_if<
+        (Position > 0),
+        decltype(std::declval<next const&>().template item<Position - 1>())
+    >::type
+    item() const noexcept {
+        return _next.template item<Position - 1>();
+    }
+
+
+    template <
+        typename Function,
+        typename ...BoolTypes
+    >
+    bool
+    visit_at(
+        std::size_t index,
+        Function&& func
+    ) const {
+        typedef selection<BoolTypes...> selected;
+        return visit_at<selected>(
+            index,
+            func,
+            std::make_index_sequence<selected::count()>()
+        );
+    }
+
+
+private:
+    /**
+     * Positions of the items selected by a sequence of criteria
+     *
+     * Items not covered by the criteria are selected.
+     */
+    template <
+        typename ...BoolTypes
+    >
+    struct selection {
+        static
+        constexpr
+        bool
+        selected(
+            std::size_t position
+        ) noexcept {
+            bool const flags[] = {BoolTypes::value..., true};
+            return position < sizeof...(BoolTypes) ? flags[position] : true;
+        }
+
+        static
+        constexpr
+        std::size_t
+        count() noexcept {
+            std::size_t retval = 0;
+            for (std::size_t i = 0; i < 1 + sizeof...(Types); ++i)
+                if (selected(i))
+                    ++retval;
+            return retval;
+        }
+
+        // position of the item with the index supplied among those selected
+        static
+        constexpr
+        std::size_t
+        position(
+            std::size_t index
+        ) noexcept {
+            std::size_t i = 0;
+            for (; i < 1 + sizeof...(Types); ++i)
+                if (selected(i) && (index-- == 0))
+                    break;
+            return i;
+        }
+    };
+
+    template <
+        typename Function,
+        std::size_t Position
+    >
+    static
+    void
+    call_at(
+        selectable_items const& items,
+        Function& func
+    ) {
+        func(items.template item<Position>());
+    }
+
+    // the item is reached via a table generated at compile time
+    template <
+        typename Selection,
+        typename Function,
+        std::size_t ...Indices
+    >
+    bool
+    visit_at(
+        std::size_t index,
+        Function& func,
+        std::index_sequence<Indices...>
+    ) const {
+        typedef void(*handler)(selectable_items const&, Function&);
+        static constexpr handler handlers[] = {
+            &call_at<Function, Selection::position(Indices)>...,
+            nullptr
+        };
+
+        if (index >= sizeof...(Indices))
+            return false;
+        handlers[index](*this, func);
+        return true;
+    }
 };
 
 
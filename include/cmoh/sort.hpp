@@ -0,0 +1,558 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_SORT_HPP__
+#define CMOH_SORT_HPP__
+
+
+// std includes
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// local includes
+#include <cmoh/parallel.hpp>
+#include <cmoh/utils.hpp>
+
+
+namespace cmoh {
+namespace sort {
+
+
+/**
+ * Order preserving mapping of a value to an unsigned integer
+ *
+ * Specializations of this template provide a member type `type`, which is an
+ * unsigned integral type, and a static method `get()`, which maps a value to
+ * a value of that type. The mapping preserves the order, e.g. if `a < b`, then
+ * `get(a) < get(b)`. Values for which such a mapping exists can be sorted
+ * using a radix sort.
+ *
+ * Specializations are provided for integral types, enumerations, floating
+ * point types and `std::chrono` durations and time points. For floating point
+ * types, negative zero is mapped like positive zero, since the two compare
+ * equal. NaNs, which are unordered, are all mapped to the maximum, i.e. they
+ * are sorted after all other values.
+ */
+template <
+    typename Value, ///< value to map
+    typename = void
+>
+struct radix_key {};
+
+// Specialization for unsigned integral types
+template <
+    typename Value
+>
+struct radix_key<
+    Value,
+    typename std::enable_if<
+        std::is_integral<Value>::value && std::is_unsigned<Value>::value
+    >::type
+> {
+    typedef Value type;
+
+    static constexpr type get(Value value) noexcept {
+        return value;
+    }
+};
+
+// Specialization for signed integral types
+template <
+    typename Value
+>
+struct radix_key<
+    Value,
+    typename std::enable_if<
+        std::is_integral<Value>::value && std::is_signed<Value>::value
+    >::type
+> {
+    typedef typename std::make_unsigned<Value>::type type;
+
+    static constexpr type get(Value value) noexcept {
+        // flipping the sign bit moves negative values below positive ones
+        return static_cast<type>(value) ^
+            (static_cast<type>(1) << (sizeof(type)*8 - 1));
+    }
+};
+
+// Specialization for enumerations
+template <
+    typename Value
+>
+struct radix_key<Value, typename std::enable_if<std::is_enum<Value>::value>::type> {
+    typedef typename std::underlying_type<Value>::type underlying;
+    typedef typename radix_key<underlying>::type type;
+
+    static constexpr type get(Value value) noexcept {
+        return radix_key<underlying>::get(static_cast<underlying>(value));
+    }
+};
+
+// Specialization for `float`
+template <>
+struct radix_key<float> {
+    typedef std::uint32_t type;
+
+    static type get(float value) noexcept {
+        static_assert(sizeof(float) == sizeof(type), "Unexpected float size");
+        if (value != value)
+            return ~type(0);
+        if (value == 0)
+            value = 0;
+        type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        // negative values are stored as magnitude, so we invert them
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+};
+
+// Specialization for `double`
+template <>
+struct radix_key<double> {
+    typedef std::uint64_t type;
+
+    static type get(double value) noexcept {
+        static_assert(sizeof(double) == sizeof(type), "Unexpected double size");
+        if (value != value)
+            return ~type(0);
+        if (value == 0)
+            value = 0;
+        type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x8000000000000000ull) ?
+            ~bits : (bits | 0x8000000000000000ull);
+    }
+};
+
+// Specialization for durations
+template <
+    typename Rep,
+    typename Period
+>
+struct radix_key<std::chrono::duration<Rep, Period>, util::void_t<typename radix_key<Rep>::type>> {
+    typedef typename radix_key<Rep>::type type;
+
+    static type get(std::chrono::duration<Rep, Period> const& value) noexcept {
+        return radix_key<Rep>::get(value.count());
+    }
+};
+
+// Specialization for time points
+template <
+    typename Clock,
+    typename Duration
+>
+struct radix_key<std::chrono::time_point<Clock, Duration>, util::void_t<typename radix_key<Duration>::type>> {
+    typedef typename radix_key<Duration>::type type;
+
+    static type get(std::chrono::time_point<Clock, Duration> const& value) noexcept {
+        return radix_key<Duration>::get(value.time_since_epoch());
+    }
+};
+
+
+/**
+ * Check whether values of a type can be sorted using a radix sort
+ *
+ * Provides the member `value`, which is `true` if `radix_key` is specialized
+ * for the type supplied.
+ */
+template <
+    typename Value,
+    typename = void
+>
+struct is_radix_sortable : std::false_type {};
+
+template <
+    typename Value
+>
+struct is_radix_sortable<Value, util::void_t<typename radix_key<Value>::type>> :
+    std::true_type {};
+
+
+/**
+ * Check whether values of a type can be sorted using cached prefixes
+ *
+ * Provides the member `value`, which is `true` for narrow character strings.
+ */
+template <
+    typename Value
+>
+struct is_prefix_sortable : std::false_type {};
+
+template <
+    typename Allocator
+>
+struct is_prefix_sortable<std::basic_string<char, std::char_traits<char>, Allocator>> :
+    std::true_type {};
+
+
+/**
+ * Minimum number of elements for which a radix sort is used
+ *
+ * For fewer elements, a comparison based sort is faster, since the histograms
+ * of the radix sort would dominate the run time.
+ */
+constexpr std::size_t radix_threshold = 64;
+
+
+/**
+ * Minimum number of elements per thread for sorting in parallel
+ *
+ * Sequences of at least twice this number of elements are sorted by multiple
+ * threads.
+ */
+constexpr std::size_t parallel_threshold = 32768;
+
+
+/**
+ * Stably sort a sequence using multiple threads
+ *
+ * The sequence is split into one part per thread. The parts are sorted in
+ * parallel and then merged pairwise, also in parallel.
+ */
+template <
+    typename RandomIt, ///< type of the iterators
+    typename Compare ///< type of the comparison function
+>
+void
+parallel_stable_sort(
+    RandomIt first, ///< start of the sequence to sort
+    RandomIt last, ///< end of the sequence to sort
+    Compare const& comp, ///< comparison function
+    std::size_t threads ///< number of threads to use
+) {
+    auto const count = static_cast<std::size_t>(last - first);
+    util::parallel_for(count, threads, [&] (
+        std::size_t,
+        std::size_t begin,
+        std::size_t end
+    ) {
+        std::stable_sort(first + begin, first + end, comp);
+    });
+
+    // the parts are split exactly like by `parallel_for()`
+    auto const bound = [&] (std::size_t part) {
+        return first + count*std::min(part, threads)/threads;
+    };
+    for (std::size_t width = 1; width < threads; width *= 2) {
+        auto const merges = (threads + 2*width - 1)/(2*width);
+        util::parallel_for(merges, merges, [&] (
+            std::size_t merge,
+            std::size_t,
+            std::size_t
+        ) {
+            auto const lower = 2*width*merge;
+            std::inplace_merge(
+                bound(lower),
+                bound(lower + width),
+                bound(lower + 2*width),
+                comp
+            );
+        });
+    }
+}
+
+
+/**
+ * Compute a stable sorting permutation for values
+ *
+ * The function extracts each of the `count` values exactly once by calling
+ * `getter` with the index of the value. The returned permutation holds, for
+ * each position in the sorted sequence, the index of the element which belongs
+ * at that position.
+ *
+ * Values for which `radix_key` is specialized are sorted using an LSD radix
+ * sort on the mapped keys, skipping passes over bytes which are identical for
+ * all keys.
+ *
+ * Sequences of at least twice `parallel_threshold` values are processed by
+ * multiple threads, by default at most one per hardware thread. For radix
+ * sortable values, the threads also extract the values. Hence, the `getter`
+ * has to be safe to call concurrently.
+ *
+ * \returns a permutation sorting the values
+ */
+template <
+    typename Value, ///< type of the values to sort
+    typename Getter ///< invocable extracting the value at an index
+>
+typename std::enable_if<
+    is_radix_sortable<Value>::value,
+    std::vector<std::size_t>
+>::type
+permutation(
+    std::size_t count, ///< number of values
+    Getter&& getter, ///< invocable extracting the value at an index
+    std::size_t threads = 0 ///< maximum number of threads, zero for a default
+) {
+    typedef typename radix_key<Value>::type key;
+    typedef std::pair<key, std::size_t> entry;
+
+    threads = util::thread_count(count, parallel_threshold, threads);
+
+    std::vector<entry> entries(count);
+    util::parallel_for(count, threads, [&] (
+        std::size_t,
+        std::size_t begin,
+        std::size_t end
+    ) {
+        for (auto i = begin; i < end; ++i)
+            entries[i] = entry(radix_key<Value>::get(getter(i)), i);
+    });
+
+    if (count < radix_threshold) {
+        std::stable_sort(
+            entries.begin(),
+            entries.end(),
+            [] (entry const& lhs, entry const& rhs) {
+                return lhs.first < rhs.first;
+            }
+        );
+    } else {
+        std::vector<entry> buffer(count);
+
+        // Each thread counts the digits of its part of the entries. The
+        // parts' buckets are then laid out one after another, so each thread
+        // may scatter its entries independently and the sort remains stable.
+        std::vector<std::array<std::size_t, 256>> histograms(threads);
+        for (std::size_t shift = 0; shift < sizeof(key)*8; shift += 8) {
+            util::parallel_for(count, threads, [&] (
+                std::size_t part,
+                std::size_t begin,
+                std::size_t end
+            ) {
+                auto& histogram = histograms[part];
+                histogram.fill(0);
+                for (auto i = begin; i < end; ++i)
+                    ++histogram[(entries[i].first >> shift) & 0xff];
+            });
+
+            // if all keys share this digit, the pass would not change anything
+            auto const digit = (entries.front().first >> shift) & 0xff;
+            std::size_t sharing = 0;
+            for (auto const& histogram : histograms)
+                sharing += histogram[digit];
+            if (sharing == count)
+                continue;
+
+            std::size_t offset = 0;
+            for (std::size_t bucket = 0; bucket < 256; ++bucket)
+                for (auto& histogram : histograms) {
+                    auto const size = histogram[bucket];
+                    histogram[bucket] = offset;
+                    offset += size;
+                }
+
+            util::parallel_for(count, threads, [&] (
+                std::size_t part,
+                std::size_t begin,
+                std::size_t end
+            ) {
+                auto& histogram = histograms[part];
+                for (auto i = begin; i < end; ++i)
+                    buffer[histogram[(entries[i].first >> shift) & 0xff]++] =
+                        entries[i];
+            });
+            entries.swap(buffer);
+        }
+    }
+
+    std::vector<std::size_t> retval;
+    retval.reserve(count);
+    for (auto const& e : entries)
+        retval.push_back(e.second);
+    return retval;
+}
+
+// overload for strings, which are sorted using a cached prefix
+template <
+    typename Value,
+    typename Getter
+>
+typename std::enable_if<
+    is_prefix_sortable<Value>::value,
+    std::vector<std::size_t>
+>::type
+permutation(
+    std::size_t count,
+    Getter&& getter,
+    std::size_t threads = 0
+) {
+    struct entry {
+        std::uint64_t prefix;
+        std::size_t index;
+    };
+
+    std::vector<Value> values;
+    values.reserve(count);
+    std::vector<entry> entries;
+    entries.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        values.emplace_back(getter(i));
+
+        // The first eight characters, interpreted as a big endian number,
+        // compare just like the strings themselves. Shorter strings are
+        // padded with zeroes.
+        auto const& value = values.back();
+        std::uint64_t prefix = 0;
+        for (std::size_t pos = 0; pos < sizeof(prefix); ++pos) {
+            prefix <<= 8;
+            if (pos < value.size())
+                prefix |= static_cast<unsigned char>(value[pos]);
+        }
+        entries.push_back(entry{prefix, i});
+    }
+
+    parallel_stable_sort(
+        entries.begin(),
+        entries.end(),
+        [&values] (entry const& lhs, entry const& rhs) {
+            if (lhs.prefix != rhs.prefix)
+                return lhs.prefix < rhs.prefix;
+            return values[lhs.index] < values[rhs.index];
+        },
+        util::thread_count(count, parallel_threshold, threads)
+    );
+
+    std::vector<std::size_t> retval;
+    retval.reserve(count);
+    for (auto const& e : entries)
+        retval.push_back(e.index);
+    return retval;
+}
+
+// overload for all other values, which are sorted using `operator <`
+template <
+    typename Value,
+    typename Getter
+>
+typename std::enable_if<
+    !is_radix_sortable<Value>::value && !is_prefix_sortable<Value>::value,
+    std::vector<std::size_t>
+>::type
+permutation(
+    std::size_t count,
+    Getter&& getter,
+    std::size_t threads = 0
+) {
+    std::vector<Value> values;
+    values.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        values.emplace_back(getter(i));
+
+    std::vector<std::size_t> retval(count);
+    for (std::size_t i = 0; i < count; ++i)
+        retval[i] = i;
+
+    parallel_stable_sort(
+        retval.begin(),
+        retval.end(),
+        [&values] (std::size_t lhs, std::size_t rhs) {
+            return values[lhs] < values[rhs];
+        },
+        util::thread_count(count, parallel_threshold, threads)
+    );
+
+    return retval;
+}
+
+
+/**
+ * Reorder a sequence according to a permutation
+ *
+ * The elements are moved in place, following the cycles of the permutation.
+ * Hence, every element is moved at most twice. The permutation has to be of
+ * the form returned by `permutation()`. It is consumed in the process.
+ */
+template <
+    typename RandomIt ///< iterator type of the sequence to reorder
+>
+void
+apply_permutation(
+    RandomIt first, ///< start of the sequence to reorder
+    std::vector<std::size_t>& perm ///< permutation to apply
+) {
+    for (std::size_t start = 0; start < perm.size(); ++start) {
+        if (perm[start] == start)
+            continue;
+
+        auto value = std::move(first[start]);
+        auto current = start;
+        while (perm[current] != start) {
+            auto const next = perm[current];
+            first[current] = std::move(first[next]);
+            perm[current] = current;
+            current = next;
+        }
+        first[current] = std::move(value);
+        perm[current] = current;
+    }
+}
+
+
+/**
+ * Sorting facility used by accessor bundles
+ *
+ * This template provides the static method `sort()`, which stably sorts a
+ * sequence of objects by values of type `Value` retrieved using a getter. The
+ * getter will be called exactly once for each object, with the object's index.
+ */
+template <
+    typename Value, ///< type of the values by which to sort
+    typename = void
+>
+struct sorter {
+    template <
+        typename RandomIt, ///< type of the iterators
+        typename Getter ///< invocable extracting the value at an index
+    >
+    static
+    void
+    sort(
+        RandomIt first, ///< start of the sequence to sort
+        RandomIt last, ///< end of the sequence to sort
+        Getter&& getter ///< invocable extracting the value at an index
+    ) {
+        auto perm = permutation<Value>(
+            static_cast<std::size_t>(last - first),
+            std::forward<Getter>(getter)
+        );
+        apply_permutation(first, perm);
+    }
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,322 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_TRACKED_HPP__
+#define CMOH_TRACKED_HPP__
+
+
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// local includes
+#include <cmoh/accessors/utils.hpp>
+#include <cmoh/optional.hpp>
+
+
+namespace cmoh {
+
+
+/**
+ * Smallest unsigned integral type holding at least `Bits` bits
+ *
+ * The type is exported via the member `type`.
+ */
+template <
+    std::size_t Bits ///< number of bits required
+>
+struct bitset_word {
+    static_assert(Bits <= 64, "No integral type with enough bits available");
+
+    typedef typename std::conditional<
+        (Bits <= 8),
+        std::uint8_t,
+        typename std::conditional<
+            (Bits <= 16),
+            std::uint16_t,
+            typename std::conditional<
+                (Bits <= 32),
+                std::uint32_t,
+                std::uint64_t
+            >::type
+        >::type
+    >::type type;
+};
+
+
+/**
+ * Object tracking modifications of its attributes
+ *
+ * A tracked object holds an object of the bundle's object type along with a
+ * set of dirty flags, one for each settable attribute. Attributes are set via
+ * the tracked object's `set()` methods, which mirror those of the bundle but
+ * mark the attribute as dirty in the process. The dirty flags are stored in
+ * a single unsigned integer, indexed by the bundle's `settable_index()`.
+ * Hence, bundles may contain at most 64 settable attributes.
+ *
+ * Modifications can be retrieved without comparing the object to a previous
+ * copy via `visit_dirty()` or `flush()`.
+ *
+ * Tracked objects hold a reference to the bundle they were created with.
+ * Hence, the bundle has to outlive them. Users are discouraged from
+ * constructing tracked objects directly. Use `track()` instead.
+ */
+template <
+    typename Bundle ///< accessor bundle used for accessing the object
+>
+class tracked {
+public:
+    typedef typename Bundle::key_type key_type;
+    typedef typename Bundle::object_type object_type;
+
+    /**
+     * Type holding the dirty flags
+     */
+    typedef typename bitset_word<Bundle::settable_count>::type dirty_set;
+
+
+    tracked(Bundle const& bundle, object_type object) :
+        _bundle(bundle), _object(std::move(object)), _dirty(0) {}
+    tracked(tracked const&) = default;
+    tracked(tracked&&) = default;
+
+
+    /**
+     * Get the object being tracked
+     *
+     * \returns a const reference to the object
+     */
+    object_type const&
+    object() const noexcept {
+        return _object;
+    }
+
+
+    /**
+     * Get the value of a specific attribute
+     *
+     * \returns the value of the attribute
+     */
+    template <
+        key_type key ///< key of attribute to get
+    >
+    typename Bundle::template property_by_key<key>::type
+    get() const {
+        return _bundle.template get<key>(_object);
+    }
+
+    /**
+     * Set the value of a specific attribute and mark it as dirty
+     */
+    template <
+        key_type key ///< key of attribute to set
+    >
+    void
+    set(
+        typename Bundle::template property_by_key<key>::type&& value ///< value to set
+    ) {
+        _bundle.template set<key>(
+            _object,
+            std::forward<typename Bundle::template property_by_key<key>::type>(
+                value
+            )
+        );
+        _dirty |= flag(Bundle::template settable_index<key>());
+    }
+
+
+    /**
+     * Get the value of a specific attribute
+     *
+     * \returns an optional holding the value of the attribute
+     */
+    template <
+        typename Type, ///< type of the attribute to get
+        typename KeyType = key_type ///< key type to use
+    >
+    optional<Type>
+    get(
+        KeyType&& key ///< key of the attribute to get
+    ) const {
+        return _bundle.template get<Type>(_object, std::forward<KeyType>(key));
+    }
+
+    /**
+     * Set the value of a specific attribute and mark it as dirty
+     *
+     * \returns true if the attribute was set, false otherwise
+     */
+    template <
+        typename Type, ///< type of the attribute to set
+        typename KeyType = key_type ///< key type to use
+    >
+    bool
+    set(
+        KeyType&& key, ///< key of the attribute to set
+        Type&& value ///< value to set
+    ) {
+        std::size_t index;
+        if (!_bundle.template set<Type>(
+            _object,
+            std::forward<KeyType>(key),
+            std::forward<Type>(value),
+            index
+        ))
+            return false;
+
+        _dirty |= flag(index);
+        return true;
+    }
+
+
+    /**
+     * Check whether a specific attribute is dirty
+     *
+     * \returns true if the attribute was set since the last flush
+     */
+    template <
+        key_type key ///< key of attribute to check
+    >
+    bool
+    is_dirty() const noexcept {
+        return _dirty & flag(Bundle::template settable_index<key>());
+    }
+
+    /**
+     * Get the dirty flags
+     *
+     * Bit n of the set returned is set if the attribute with the settable
+     * index n is dirty.
+     *
+     * \returns the set of dirty flags
+     */
+    dirty_set
+    dirty() const noexcept {
+        return _dirty;
+    }
+
+    /**
+     * Check whether any attribute is dirty
+     */
+    bool
+    modified() const noexcept {
+        return _dirty != 0;
+    }
+
+    /**
+     * Mark all attributes as clean
+     */
+    void
+    clear() noexcept {
+        _dirty = 0;
+    }
+
+
+    /**
+     * Call a function with the accessor of every dirty attribute
+     *
+     * The function will be called with the accessors as the only argument,
+     * in the order of the accessors. The attribute's key may be retrieved via
+     * `cmoh::accessors::key()`.
+     */
+    template <
+        typename Function ///< type of the function to call
+    >
+    void
+    visit_dirty(
+        Function&& function ///< function to call
+    ) const {
+        std::size_t index = 0;
+        _bundle.visit_settable_attributes([&] (auto const& accessor) {
+            if (_dirty & flag(index))
+                function(accessor);
+            ++index;
+        });
+    }
+
+    /**
+     * Serialize the dirty attributes and mark them as clean
+     *
+     * For each dirty attribute, the method `add()` of the `serializer` is
+     * called with the attribute's settable index and value, in ascending order
+     * of the indices. Hence, a `cmoh::patch` may be used as a serializer,
+     * producing a patch applicable to copies of the object.
+     */
+    template <
+        typename Serializer ///< type of the serializer
+    >
+    void
+    flush(
+        Serializer& serializer ///< serializer to use
+    ) {
+        std::size_t index = 0;
+        _bundle.visit_settable_attributes([&] (auto const& accessor) {
+            if (_dirty & flag(index))
+                serializer.add(index, accessor.get(_object));
+            ++index;
+        });
+        clear();
+    }
+
+
+private:
+    static
+    constexpr
+    dirty_set
+    flag(
+        std::size_t index
+    ) noexcept {
+        return static_cast<dirty_set>(static_cast<dirty_set>(1) << index);
+    }
+
+
+    Bundle const& _bundle;
+    object_type _object;
+    dirty_set _dirty;
+};
+
+
+/**
+ * Start tracking modifications of an object
+ *
+ * \returns a tracked object holding the object supplied, with all attributes
+ *          marked as clean
+ */
+template <
+    typename Bundle ///< accessor bundle used for accessing the object
+>
+tracked<Bundle>
+track(
+    Bundle const& bundle, ///< accessor bundle used for accessing the object
+    typename Bundle::object_type object ///< object to track
+) {
+    return tracked<Bundle>(bundle, std::move(object));
+}
+
+
+}
+
+
+#endif
@@ -59,6 +59,30 @@ struct count<> {
 };
 
 
+/**
+ * Count the type traits `Items` which hold
+ *
+ * Providing that each of the `Items` types provides a member `value` of type
+ * bool, this type provides a member `value` holding the number of `Items` for
+ * which `value` is true.
+ */
+template <
+    typename ...Items
+>
+struct count_if {
+    static constexpr unsigned long int value = 0;
+};
+
+template <
+    typename Item0,
+    typename ...Items
+>
+struct count_if<Item0, Items...> {
+    static constexpr unsigned long int value =
+        count_if<Items...>::value + (Item0::value ? 1 : 0);
+};
+
+
 /**
  * Logical conjunction of type traits `Items`
  *
@@ -0,0 +1,162 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// we _always_ want assertions
+#undef NDEBUG
+
+// std includes
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// CMOH includes
+#include <cmoh/accessor_bundle.hpp>
+#include <cmoh/attribute.hpp>
+#include <cmoh/factory.hpp>
+
+// local includes
+#include "../examples/person.hpp"
+#include "allocations.hpp"
+
+
+/*
+ * Assertions on the dynamic allocations performed by accessor bundles
+ *
+ * Accessing attributes of trivially copyable types must never allocate. For
+ * attributes of type `std::string`, we rely on the small string optimization
+ * for short values, which is provided by all major implementations for
+ * strings of up to ten characters.
+ */
+
+
+
+
+enum attribute {birthday, first_name, last_name, age, id, weight};
+
+using birthday_attr = cmoh::attribute<attribute, birthday,
+    const std::chrono::system_clock::time_point>;
+using first_name_attr = cmoh::attribute<attribute, first_name, std::string>;
+using last_name_attr = cmoh::attribute<attribute, last_name, std::string>;
+using age_attr = cmoh::attribute<attribute, age, const std::chrono::hours>;
+using id_attr = cmoh::attribute<attribute, id, int>;
+using weight_attr = cmoh::attribute<attribute, weight, double>;
+
+
+struct record {
+    int id;
+    double weight;
+};
+
+
+// a value too long for any small string optimization
+std::string const long_name(64, 'x');
+
+
+
+
+int main(int argc, char* argv[]) {
+    using test::count_allocations;
+
+    auto const people = cmoh::bundle(
+        cmoh::factory<person, birthday_attr>(),
+        first_name_attr::accessor<person>(&person::first_name, &person::set_first_name),
+        last_name_attr::accessor<person>(&person::last_name, &person::set_last_name),
+        age_attr::accessor<person>(&person::age)
+    );
+
+    auto const records = cmoh::bundle(
+        id_attr::accessor<record>(offsetof(record, id)),
+        weight_attr::accessor<record>(offsetof(record, weight))
+    );
+
+    auto now = std::chrono::system_clock::now();
+
+    // The scope itself works as expected.
+    {
+        test::allocation_scope scope;
+        int* volatile allocated = new int(1);
+        delete allocated;
+        assert(scope.allocations() == 1);
+        assert(scope.deallocations() == 1);
+        assert(scope.bytes() >= sizeof(int));
+    }
+
+    // Creating a person with short names does not allocate.
+    person p(now);
+    assert(count_allocations([&] {
+        p = people.create<birthday, first_name, last_name>(
+            std::chrono::system_clock::time_point(now),
+            std::string("Hans"),
+            std::string("Wurst")
+        );
+    }) == 0);
+
+    // Neither does accessing attributes of trivially copyable types nor
+    // short strings, both via static and dynamic keys.
+    assert(count_allocations([&] {
+        assert(people.get<age>(p) >= std::chrono::hours(0));
+        assert(people.get<first_name>(p) == "Hans");
+        assert(*people.get<std::string>(p, last_name) == "Wurst");
+        people.set<first_name>(p, "Henrick");
+        assert(people.set<std::string>(p, last_name, std::string("Meier")));
+    }) == 0);
+
+    // Accessors returning strings by value copy long ones. Setters taking a
+    // const reference copy the value, too.
+    std::string name = long_name;
+    assert(count_allocations([&] {
+        people.set<first_name>(p, std::move(name));
+    }) == 1);
+    assert(count_allocations([&] {
+        assert(people.get<first_name>(p).size() == long_name.size());
+    }) == 1);
+
+    // Visiting properties does not allocate.
+    assert(count_allocations([&] {
+        std::size_t visited = 0;
+        people.visit_properties([&] (auto const&) { ++visited; });
+        assert(visited == 3);
+    }) == 0);
+
+    // Neither does looking up the indices of attributes at run time, even
+    // when the hash table is built.
+    assert(count_allocations([&] {
+        assert(people.index_of(last_name) == 1);
+        assert(people.index_of(weight) == people.npos);
+    }) == 0);
+
+    // Accessing plain structs by offset never allocates.
+    record r{1, 2.};
+    assert(count_allocations([&] {
+        records.set<id>(r, 3);
+        records.set<weight>(r, 4.);
+        assert(records.get<id>(r) == 3);
+        assert(*records.get<double>(r, weight) == 4.);
+        assert(records.set<int>(r, id, 5));
+    }) == 0);
+
+    return 0;
+}
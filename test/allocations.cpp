@@ -0,0 +1,81 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// std includes
+#include <cstdlib>
+#include <new>
+
+// local includes
+#include "allocations.hpp"
+
+
+namespace {
+    // innermost scope active in the current thread
+    thread_local test::allocation_scope* current = nullptr;
+}
+
+
+test::allocation_scope::allocation_scope() noexcept : _outer(current) {
+    current = this;
+}
+
+test::allocation_scope::~allocation_scope() noexcept {
+    current = _outer;
+}
+
+void test::allocation_scope::record_allocation(std::size_t size) noexcept {
+    for (auto scope = current; scope; scope = scope->_outer) {
+        ++scope->_allocations;
+        scope->_bytes += size;
+    }
+}
+
+void test::allocation_scope::record_deallocation() noexcept {
+    for (auto scope = current; scope; scope = scope->_outer)
+        ++scope->_deallocations;
+}
+
+
+
+
+// Replacements of the global allocation functions. The array and nothrow
+// variants forward to these by default.
+
+void* operator new(std::size_t size) {
+    test::allocation_scope::record_allocation(size);
+    if (void* retval = std::malloc(size ? size : 1))
+        return retval;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr)
+        test::allocation_scope::record_deallocation();
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
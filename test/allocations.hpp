@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Julian Ganz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CMOH_TEST_ALLOCATIONS_HPP__
+#define CMOH_TEST_ALLOCATIONS_HPP__
+
+
+// std includes
+#include <cstddef>
+
+
+namespace test {
+
+
+/**
+ * Scope counting dynamic allocations
+ *
+ * While an allocation scope exists, allocations and deallocations performed
+ * by the current thread via the global `operator new` and `operator delete`
+ * are counted. Scopes may be nested, in which case an allocation is counted
+ * by all enclosing scopes.
+ *
+ * The replacements of the global operators are defined in `allocations.cpp`,
+ * which has to be linked into the test program.
+ */
+class allocation_scope {
+public:
+    allocation_scope() noexcept;
+    allocation_scope(allocation_scope const&) = delete;
+    allocation_scope(allocation_scope&&) = delete;
+    ~allocation_scope() noexcept;
+
+    /**
+     * Get the number of allocations performed within the scope
+     */
+    std::size_t
+    allocations() const noexcept {
+        return _allocations;
+    }
+
+    /**
+     * Get the number of deallocations performed within the scope
+     */
+    std::size_t
+    deallocations() const noexcept {
+        return _deallocations;
+    }
+
+    /**
+     * Get the number of bytes allocated within the scope
+     */
+    std::size_t
+    bytes() const noexcept {
+        return _bytes;
+    }
+
+    // record an allocation or deallocation in all active scopes
+    static void record_allocation(std::size_t size) noexcept;
+    static void record_deallocation() noexcept;
+
+private:
+    allocation_scope* _outer;
+    std::size_t _allocations = 0;
+    std::size_t _deallocations = 0;
+    std::size_t _bytes = 0;
+};
+
+
+/**
+ * Count the allocations performed by a function
+ *
+ * \returns the number of allocations performed by `function`
+ */
+template <
+    typename Function ///< type of the function to call
+>
+std::size_t
+count_allocations(
+    Function&& function ///< function to call
+) {
+    allocation_scope scope;
+    function();
+    return scope.allocations();
+}
+
+
+}
+
+
+#endif